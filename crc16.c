@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    crc16.c
+  * @brief   CRC16-CCITT校验实现 (逐位计算, 不占用查表空间)
+  ******************************************************************************
+  */
+
+#include "crc16.h"
+
+/* ==================== 公开函数 ==================== */
+
+uint16_t Crc16_Update(uint16_t crc, uint8_t byte)
+{
+    uint8_t i;
+
+    crc ^= (uint16_t)byte << 8;
+    for (i = 0; i < 8; i++) {
+        crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+uint16_t Crc16_Calc(const uint8_t *p, uint16_t len)
+{
+    uint16_t crc = CRC16_INIT;
+
+    while (len--) {
+        crc = Crc16_Update(crc, *p++);
+    }
+    return crc;
+}
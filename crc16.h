@@ -0,0 +1,28 @@
+/**
+  ******************************************************************************
+  * @file    crc16.h
+  * @brief   CRC16-CCITT校验
+  * @details 多项式0x1021, 初值0xFFFF, 输入输出不反转, 结果不异或 (CRC-16/CCITT-FALSE).
+  *          备份SRAM回零记录、Flash标定记录与视觉全目标帧共用此实现
+  ******************************************************************************
+  */
+
+#ifndef __CRC16_H
+#define __CRC16_H
+
+#include <stdint.h>
+
+#define CRC16_INIT              0xFFFFU     // 初值
+
+/**
+ * @brief 逐字节累加, 用于不连续存放的数据 (如环形缓冲区)
+ * @param crc 上次结果, 首字节传CRC16_INIT
+ */
+uint16_t Crc16_Update(uint16_t crc, uint8_t byte);
+
+/**
+ * @brief 计算连续数据的CRC16
+ */
+uint16_t Crc16_Calc(const uint8_t *p, uint16_t len);
+
+#endif /* __CRC16_H */
@@ -0,0 +1,478 @@
+/**
+  ******************************************************************************
+  * @file    emm_bus.c
+  * @brief   Emm_V5电机总线发送队列实现
+  ******************************************************************************
+  */
+
+#include "emm_bus.h"
+#include <string.h>
+
+/* ==================== 私有类型 ==================== */
+
+typedef struct {
+    uint8_t data[EMM_BUS_FRAME_MAX];
+    uint8_t len;
+} EmmBusSlot_t;
+
+typedef struct {
+    UART_HandleTypeDef *huart;
+    EmmBusSlot_t  slot[EMM_BUS_QUEUE_DEPTH];
+    __IO uint8_t  head;         // 生产者(主循环)写入位置
+    __IO uint8_t  tail;         // 消费者(DMA完成中断)读取位置
+    __IO bool     busy;         // DMA正在发送slot[tail]
+    EmmBusStats_t stats;
+} EmmBusQueue_t;
+
+#define EMM_BUS_MASK    (EMM_BUS_QUEUE_DEPTH - 1U)
+
+/* ==================== 私有变量 ==================== */
+
+static EmmBusQueue_t s_queue[EMM_BUS_MAX_UART];
+static uint8_t       s_queue_count = 0;
+static UART_HandleTypeDef *s_route[EMM_BUS_ROUTE_MAX_ADDR] = EMM_BUS_ROUTE_TABLE;
+
+/* ==================== 私有函数 ==================== */
+
+/**
+ * @brief 查找已管理的串口队列
+ * @return NULL=该串口不是电机总线 (如视觉串口USART3)
+ */
+static EmmBusQueue_t *find_queue(UART_HandleTypeDef *huart)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_queue_count; i++) {
+        if (s_queue[i].huart == huart) {
+            return &s_queue[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 登记电机串口, 已登记时返回原队列; 只由Emm_Bus_Init/Emm_Bus_Set_Route调用
+ */
+static EmmBusQueue_t *add_queue(UART_HandleTypeDef *huart)
+{
+    EmmBusQueue_t *q = find_queue(huart);
+
+    if (q != NULL) {
+        return q;
+    }
+    if (s_queue_count < EMM_BUS_MAX_UART && huart != NULL) {
+        EmmBusQueue_t *q = &s_queue[s_queue_count++];
+        q->huart = huart;
+        q->head = q->tail = 0;
+        q->busy = false;
+        return q;
+    }
+    return NULL;
+}
+
+static uint8_t queue_used(const EmmBusQueue_t *q)
+{
+    return (uint8_t)((q->head - q->tail) & 0xFFU);
+}
+
+/**
+ * @brief 总线空闲且有待发帧时启动DMA
+ * @note 主循环与DMA完成中断都会调用, 需关中断保护busy判断;
+ *       启动失败(串口被阻塞发送占用等)时帧保留在队首, 不丢弃运动命令,
+ *       由下一次入队/背压等待/Emm_Bus_Flush/Emm_Bus_Process重新启动
+ */
+static void queue_kick(EmmBusQueue_t *q)
+{
+    EmmBusSlot_t *s;
+    uint8_t attempt;
+
+    __disable_irq();
+    if (q->busy || q->tail == q->head) {
+        __enable_irq();
+        return;
+    }
+    q->busy = true;
+    __enable_irq();
+
+    s = &q->slot[q->tail & EMM_BUS_MASK];
+    for (attempt = 0; attempt < EMM_BUS_KICK_RETRY; attempt++) {
+        if (HAL_UART_Transmit_DMA(q->huart, s->data, s->len) == HAL_OK) {
+            return;
+        }
+    }
+    q->stats.kick_retry++;
+    q->busy = false;
+}
+
+/**
+ * @brief 为一次突发申请帧槽, 队列满时等待(背压)
+ */
+static uint8_t *burst_alloc(UART_HandleTypeDef *huart, uint8_t len)
+{
+    uint32_t tickstart = HAL_GetTick();
+    uint8_t *buf;
+
+    while ((buf = Emm_Bus_Alloc(huart, len)) == NULL) {
+        if (HAL_GetTick() - tickstart > EMM_BUS_SEND_TIMEOUT_MS) {
+            EmmBusQueue_t *q = find_queue(huart);
+            if (q != NULL) q->stats.dropped++;
+            return NULL;
+        }
+    }
+    return buf;
+}
+
+/**
+ * @brief 按地址路由分组的多串口同步突发 (pos与vel二选一)
+ * @note 先在每路串口上申请好整段突发的帧槽(背压等待在此完成), 全部成功后才组帧入队;
+ *       任一路申请失败则所有串口都不发送, 不会出现一路已同步触发而另一路没有的情况
+ */
+static bool routed_burst(const EmmPosCmd_t *pos, const EmmVelCmd_t *vel, uint8_t count)
+{
+    uint8_t idx[EMM_BUS_MAX_UART][EMM_BUS_BURST_MAX_AXES];
+    uint8_t n[EMM_BUS_MAX_UART] = { 0 };
+    uint8_t *buf[EMM_BUS_MAX_UART];
+    uint8_t frame_len = (pos != NULL) ? EMM_POS_FRAME_LEN : EMM_VEL_FRAME_LEN;
+    uint8_t q, i;
+
+    if ((pos == NULL && vel == NULL) || count == 0) {
+        return false;
+    }
+    for (i = 0; i < count; i++) {
+        uint8_t addr = (pos != NULL) ? pos[i].addr : vel[i].addr;
+        EmmBusQueue_t *bq = find_queue(Emm_Bus_Route(addr));
+
+        if (bq == NULL) {
+            return false;
+        }
+        q = (uint8_t)(bq - s_queue);
+        if (n[q] >= EMM_BUS_BURST_MAX_AXES) {
+            return false;
+        }
+        idx[q][n[q]++] = i;
+    }
+
+    for (q = 0; q < s_queue_count; q++) {
+        if (n[q] != 0) {
+            buf[q] = burst_alloc(s_queue[q].huart, (uint8_t)(n[q] * frame_len + EMM_SYNC_FRAME_LEN));
+            if (buf[q] == NULL) {
+                return false;       // 尚未提交任何一路
+            }
+        }
+    }
+
+    for (q = 0; q < s_queue_count; q++) {
+        uint8_t *p = buf[q];
+
+        if (n[q] == 0) {
+            continue;
+        }
+        for (i = 0; i < n[q]; i++) {
+            if (pos != NULL) {
+                const EmmPosCmd_t *c = &pos[idx[q][i]];
+                p += Emm_Bus_Build_Pos(p, c->addr, c->dir, c->vel, c->acc, c->clk, c->raF, true);
+            } else {
+                const EmmVelCmd_t *c = &vel[idx[q][i]];
+                p += Emm_Bus_Build_Vel(p, c->addr, c->dir, c->vel, c->acc, true);
+            }
+        }
+        Emm_Bus_Build_Sync(p, EMM_BROADCAST_ADDR);
+        Emm_Bus_Commit(s_queue[q].huart);
+    }
+    return true;
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Emm_Bus_Init(void)
+{
+    uint8_t i;
+
+    memset(s_queue, 0, sizeof(s_queue));
+    s_queue_count = 0;
+    add_queue(EMM_BUS_UART);
+    for (i = 0; i < EMM_BUS_ROUTE_MAX_ADDR; i++) {
+        add_queue(s_route[i]);
+    }
+}
+
+UART_HandleTypeDef *Emm_Bus_Route(uint8_t addr)
+{
+    return (addr < EMM_BUS_ROUTE_MAX_ADDR) ? s_route[addr] : EMM_BUS_UART;
+}
+
+void Emm_Bus_Set_Route(uint8_t addr, UART_HandleTypeDef *huart)
+{
+    if (addr < EMM_BUS_ROUTE_MAX_ADDR && huart != NULL) {
+        s_route[addr] = huart;
+        add_queue(huart);
+    }
+}
+
+uint8_t Emm_Bus_Uart_List(UART_HandleTypeDef **list)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_queue_count; i++) {
+        list[i] = s_queue[i].huart;
+    }
+    return s_queue_count;
+}
+
+bool Emm_Bus_Send_Routed(const uint8_t *data, uint8_t len)
+{
+    bool ok = true;
+    uint8_t i;
+
+    if (len == 0) {
+        return false;
+    }
+    if (data[0] != EMM_BROADCAST_ADDR) {
+        return Emm_Bus_Send(Emm_Bus_Route(data[0]), data, len);
+    }
+    for (i = 0; i < s_queue_count; i++) {
+        ok &= Emm_Bus_Send(s_queue[i].huart, data, len);
+    }
+    return ok;
+}
+
+uint8_t *Emm_Bus_Alloc(UART_HandleTypeDef *huart, uint8_t len)
+{
+    EmmBusQueue_t *q = find_queue(huart);
+
+    if (q == NULL || len == 0 || len > EMM_BUS_FRAME_MAX) {
+        return NULL;
+    }
+    if (queue_used(q) >= EMM_BUS_QUEUE_DEPTH) {
+        queue_kick(q);          // 队首帧启动失败时队列不会自行排空
+        return NULL;
+    }
+    q->slot[q->head & EMM_BUS_MASK].len = len;
+    return q->slot[q->head & EMM_BUS_MASK].data;
+}
+
+void Emm_Bus_Commit(UART_HandleTypeDef *huart)
+{
+    EmmBusQueue_t *q = find_queue(huart);
+    uint8_t used;
+
+    if (q == NULL) {
+        return;
+    }
+    q->stats.frames++;
+    q->stats.bytes += q->slot[q->head & EMM_BUS_MASK].len;
+    q->head++;
+
+    used = queue_used(q);
+    if (used > q->stats.high_water) {
+        q->stats.high_water = used;
+    }
+    queue_kick(q);
+}
+
+bool Emm_Bus_TrySend(UART_HandleTypeDef *huart, const uint8_t *data, uint8_t len)
+{
+    uint8_t *buf = Emm_Bus_Alloc(huart, len);
+
+    if (buf == NULL) {
+        return false;
+    }
+    memcpy(buf, data, len);
+    Emm_Bus_Commit(huart);
+    return true;
+}
+
+bool Emm_Bus_Send(UART_HandleTypeDef *huart, const uint8_t *data, uint8_t len)
+{
+    uint32_t tickstart = HAL_GetTick();
+    EmmBusQueue_t *q = find_queue(huart);
+
+    if (q == NULL || len == 0 || len > EMM_BUS_FRAME_MAX) {
+        if (q != NULL) q->stats.dropped++;
+        return false;
+    }
+
+    while (!Emm_Bus_TrySend(huart, data, len)) {
+        if (HAL_GetTick() - tickstart > EMM_BUS_SEND_TIMEOUT_MS) {
+            q->stats.dropped++;
+            return false;
+        }
+    }
+    return true;
+}
+
+uint8_t Emm_Bus_Pending(UART_HandleTypeDef *huart)
+{
+    EmmBusQueue_t *q = find_queue(huart);
+
+    return (q != NULL) ? queue_used(q) : 0;
+}
+
+bool Emm_Bus_Flush(UART_HandleTypeDef *huart, uint32_t timeout_ms)
+{
+    uint32_t tickstart = HAL_GetTick();
+    EmmBusQueue_t *q = find_queue(huart);
+
+    if (q == NULL) {
+        return true;
+    }
+    while (queue_used(q) != 0) {
+        queue_kick(q);
+        if (HAL_GetTick() - tickstart > timeout_ms) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Emm_Bus_Process(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_queue_count; i++) {
+        queue_kick(&s_queue[i]);
+    }
+}
+
+const EmmBusStats_t *Emm_Bus_Get_Stats(UART_HandleTypeDef *huart)
+{
+    EmmBusQueue_t *q = find_queue(huart);
+
+    return (q != NULL) ? &q->stats : NULL;
+}
+
+uint8_t Emm_Bus_Build_Pos(uint8_t *buf, uint8_t addr, uint8_t dir, uint16_t vel,
+                          uint8_t acc, uint32_t clk, bool raF, bool snF)
+{
+    buf[0]  = addr;
+    buf[1]  = 0xFD;
+    buf[2]  = dir;
+    buf[3]  = (uint8_t)(vel >> 8);
+    buf[4]  = (uint8_t)(vel >> 0);
+    buf[5]  = acc;
+    buf[6]  = (uint8_t)(clk >> 24);
+    buf[7]  = (uint8_t)(clk >> 16);
+    buf[8]  = (uint8_t)(clk >> 8);
+    buf[9]  = (uint8_t)(clk >> 0);
+    buf[10] = raF ? 0x01 : 0x00;
+    buf[11] = snF ? 0x01 : 0x00;
+    buf[12] = 0x6B;
+    return EMM_POS_FRAME_LEN;
+}
+
+uint8_t Emm_Bus_Build_Vel(uint8_t *buf, uint8_t addr, uint8_t dir, uint16_t vel,
+                          uint8_t acc, bool snF)
+{
+    buf[0] = addr;
+    buf[1] = 0xF6;
+    buf[2] = dir;
+    buf[3] = (uint8_t)(vel >> 8);
+    buf[4] = (uint8_t)(vel >> 0);
+    buf[5] = acc;
+    buf[6] = snF ? 0x01 : 0x00;
+    buf[7] = 0x6B;
+    return EMM_VEL_FRAME_LEN;
+}
+
+uint8_t Emm_Bus_Build_Sync(uint8_t *buf, uint8_t addr)
+{
+    buf[0] = addr;
+    buf[1] = 0xFF;
+    buf[2] = 0x66;
+    buf[3] = 0x6B;
+    return EMM_SYNC_FRAME_LEN;
+}
+
+uint8_t Emm_Bus_Build_Read(uint8_t *buf, uint8_t addr, SysParams_t s)
+{
+    uint8_t i = 0;
+
+    buf[i++] = addr;
+    switch (s) {
+        case S_VER:   buf[i++] = 0x1F; break;
+        case S_RL:    buf[i++] = 0x20; break;
+        case S_PID:   buf[i++] = 0x21; break;
+        case S_VBUS:  buf[i++] = 0x24; break;
+        case S_CPHA:  buf[i++] = 0x27; break;
+        case S_ENCL:  buf[i++] = 0x31; break;
+        case S_TPOS:  buf[i++] = 0x33; break;
+        case S_VEL:   buf[i++] = 0x35; break;
+        case S_CPOS:  buf[i++] = 0x36; break;
+        case S_PERR:  buf[i++] = 0x37; break;
+        case S_FLAG:  buf[i++] = 0x3A; break;
+        case S_ORG:   buf[i++] = 0x3B; break;
+        case S_Conf:  buf[i++] = 0x42; buf[i++] = 0x6C; break;
+        case S_State: buf[i++] = 0x43; buf[i++] = 0x7A; break;
+        default:      return 0;
+    }
+    buf[i++] = 0x6B;
+    return i;
+}
+
+bool Emm_Bus_Sync_Pos_Burst(UART_HandleTypeDef *huart, const EmmPosCmd_t *cmds, uint8_t count)
+{
+    uint8_t *buf;
+    uint8_t i;
+
+    if (cmds == NULL || count == 0 || count > EMM_BUS_BURST_MAX_AXES) {
+        return false;
+    }
+    buf = burst_alloc(huart, (uint8_t)(count * EMM_POS_FRAME_LEN + EMM_SYNC_FRAME_LEN));
+    if (buf == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        buf += Emm_Bus_Build_Pos(buf, cmds[i].addr, cmds[i].dir, cmds[i].vel,
+                                 cmds[i].acc, cmds[i].clk, cmds[i].raF, true);
+    }
+    Emm_Bus_Build_Sync(buf, EMM_BROADCAST_ADDR);
+    Emm_Bus_Commit(huart);
+    return true;
+}
+
+bool Emm_Bus_Sync_Vel_Burst(UART_HandleTypeDef *huart, const EmmVelCmd_t *cmds, uint8_t count)
+{
+    uint8_t *buf;
+    uint8_t i;
+
+    if (cmds == NULL || count == 0 || count > EMM_BUS_BURST_MAX_AXES) {
+        return false;
+    }
+    buf = burst_alloc(huart, (uint8_t)(count * EMM_VEL_FRAME_LEN + EMM_SYNC_FRAME_LEN));
+    if (buf == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        buf += Emm_Bus_Build_Vel(buf, cmds[i].addr, cmds[i].dir, cmds[i].vel, cmds[i].acc, true);
+    }
+    Emm_Bus_Build_Sync(buf, EMM_BROADCAST_ADDR);
+    Emm_Bus_Commit(huart);
+    return true;
+}
+
+bool Emm_Bus_Sync_Pos_Routed(const EmmPosCmd_t *cmds, uint8_t count)
+{
+    return routed_burst(cmds, NULL, count);
+}
+
+bool Emm_Bus_Sync_Vel_Routed(const EmmVelCmd_t *cmds, uint8_t count)
+{
+    return routed_burst(NULL, cmds, count);
+}
+
+void Emm_Bus_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_queue_count; i++) {
+        EmmBusQueue_t *q = &s_queue[i];
+        if (q->huart == huart && q->busy) {
+            q->tail++;
+            q->busy = false;
+            queue_kick(q);
+            return;
+        }
+    }
+}
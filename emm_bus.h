@@ -0,0 +1,246 @@
+/**
+  ******************************************************************************
+  * @file    emm_bus.h
+  * @brief   Emm_V5电机总线发送队列头文件
+  * @details 每路串口一个帧环形队列, 由UART TX DMA在发送完成中断中自动续传:
+  *          - 入队立即返回, 调用者不再等待整帧的线上时间
+  *          - Emm_Bus_Alloc/Commit 直接在队列槽中组帧, 无额外拷贝
+  *          - 队列满时 Emm_Bus_Send 等待空槽(背压), Emm_Bus_TrySend 直接失败
+  *          - 按驱动器地址路由到不同串口, 各串口的DMA并行发送
+  ******************************************************************************
+  */
+
+#ifndef __EMM_BUS_H
+#define __EMM_BUS_H
+
+#include "usart.h"
+#include "Emm_V5.h"
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+#define EMM_BUS_UART                (&huart1)   // 电机总线默认串口
+#define EMM_BUS_MAX_UART            3           // 最多管理的串口数
+#define EMM_BUS_FRAME_MAX           64          // 单个队列槽最大字节数
+#define EMM_BUS_QUEUE_DEPTH         16          // 每路串口的帧槽数 (必须为2的幂)
+#define EMM_BUS_SEND_TIMEOUT_MS     20          // 背压等待超时 (ms)
+#define EMM_BUS_KICK_RETRY          3           // DMA启动失败时立即重试的次数
+
+/* Emm_V5帧长度 */
+#define EMM_POS_FRAME_LEN           13          // 位置模式控制
+#define EMM_VEL_FRAME_LEN           8           // 速度模式控制
+#define EMM_SYNC_FRAME_LEN          4           // 多机同步运动
+#define EMM_READ_FRAME_MAX          4           // 读取参数 (S_Conf/S_State为4字节, 其余3字节)
+#define EMM_BROADCAST_ADDR          0           // 广播地址
+
+/*
+ * 地址 -> 串口路由表 (下标为驱动器地址, 地址定义见motor.h/gripper.h):
+ *   1=左前 3=左后 -> USART1,  2=右前 4=右后 -> USART2,  6=升降 -> USART1
+ * USART3为视觉通信口. 全部改为EMM_BUS_UART即恢复单总线接线
+ */
+#define EMM_BUS_ROUTE_MAX_ADDR      8
+#define EMM_BUS_ROUTE_TABLE         {                                   \
+    EMM_BUS_UART,   /* 0 广播, 发往所有电机串口 */                         \
+    &huart1,        /* 1 左前轮 */                                         \
+    &huart2,        /* 2 右前轮 */                                         \
+    &huart1,        /* 3 左后轮 */                                         \
+    &huart2,        /* 4 右后轮 */                                         \
+    EMM_BUS_UART,   /* 5 */                                                \
+    &huart1,        /* 6 升降电机 */                                       \
+    EMM_BUS_UART    /* 7 */                                                \
+}
+
+// 单次突发最多打包的轴数: N个位置帧 + 1个同步帧 <= EMM_BUS_FRAME_MAX
+#define EMM_BUS_BURST_MAX_AXES      ((EMM_BUS_FRAME_MAX - EMM_SYNC_FRAME_LEN) / EMM_POS_FRAME_LEN)
+
+/* ==================== 类型定义 ==================== */
+
+/**
+ * @brief 单路串口发送统计
+ */
+typedef struct {
+    uint32_t frames;        // 已入队帧数
+    uint32_t bytes;         // 已入队字节数
+    uint32_t dropped;       // 背压超时或参数错误丢弃的帧数
+    uint32_t kick_retry;    // DMA启动失败、帧留在队首等待重新启动的次数
+    uint8_t  high_water;    // 队列最大占用槽数
+} EmmBusStats_t;
+
+/**
+ * @brief 单轴位置命令 (对应Emm_V5_Pos_Control的参数)
+ */
+typedef struct {
+    uint8_t  addr;          // 电机地址
+    uint8_t  dir;           // 方向 0=CW 1=CCW
+    uint16_t vel;           // 速度 (RPM)
+    uint8_t  acc;           // 加速度档位 0~255
+    uint32_t clk;           // 脉冲数
+    bool     raF;           // true=绝对位置 false=相对位置
+} EmmPosCmd_t;
+
+/**
+ * @brief 单轴速度命令 (对应Emm_V5_Vel_Control的参数)
+ */
+typedef struct {
+    uint8_t  addr;          // 电机地址
+    uint8_t  dir;           // 方向 0=CW 1=CCW
+    uint16_t vel;           // 速度 (RPM)
+    uint8_t  acc;           // 加速度档位 0~255
+} EmmVelCmd_t;
+
+/* ==================== 公开函数声明 ==================== */
+
+/**
+ * @brief 初始化电机总线发送队列
+ * @note 在MX_USARTx_UART_Init()和MX_DMA_Init()之后调用
+ */
+void Emm_Bus_Init(void);
+
+/**
+ * @brief 查询驱动器地址所在的串口
+ * @param addr 驱动器地址, 超出路由表范围时返回EMM_BUS_UART
+ */
+UART_HandleTypeDef *Emm_Bus_Route(uint8_t addr);
+
+/**
+ * @brief 修改驱动器地址的路由, 需在该地址发送任何命令之前调用
+ * @note 新串口在此登记为电机总线; 只有Emm_Bus_Init与本函数会登记串口
+ */
+void Emm_Bus_Set_Route(uint8_t addr, UART_HandleTypeDef *huart);
+
+/**
+ * @brief 获取路由表中用到的全部电机串口 (去重)
+ * @param list 输出串口列表, 至少EMM_BUS_MAX_UART项
+ * @return 串口数量
+ * @note 用于逐路启动接收: Emm_Rx_Init(list[i])
+ */
+uint8_t Emm_Bus_Uart_List(UART_HandleTypeDef **list);
+
+/**
+ * @brief 按帧首字节(驱动器地址)路由发送, 广播帧发往所有电机串口
+ * @return true=已入队, false=任一串口等待超时
+ * @note Emm_V5层所有命令经由usart_SendCmd()调用本函数
+ */
+bool Emm_Bus_Send_Routed(const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 在队列中申请一个帧槽, 调用者直接在返回的缓冲区中组帧
+ * @param huart 目标串口
+ * @param len   帧长度 (字节), 不超过EMM_BUS_FRAME_MAX
+ * @return 帧缓冲区指针, 队列满、串口不是电机总线或参数错误时返回NULL
+ * @note 必须随后调用Emm_Bus_Commit()提交, 两者之间不得再次申请
+ */
+uint8_t *Emm_Bus_Alloc(UART_HandleTypeDef *huart, uint8_t len);
+
+/**
+ * @brief 提交最近一次Emm_Bus_Alloc()申请的帧, 总线空闲时立即启动DMA
+ * @param huart 目标串口
+ */
+void Emm_Bus_Commit(UART_HandleTypeDef *huart);
+
+/**
+ * @brief 拷贝一帧到发送队列, 队列满时立即返回
+ * @return true=已入队, false=队列满
+ */
+bool Emm_Bus_TrySend(UART_HandleTypeDef *huart, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 拷贝一帧到发送队列, 队列满时等待空槽
+ * @return true=已入队, false=等待超时(帧被丢弃)
+ */
+bool Emm_Bus_Send(UART_HandleTypeDef *huart, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief 获取串口队列中尚未发送完成的帧数(含正在发送的一帧)
+ * @return 串口不是电机总线时返回0
+ */
+uint8_t Emm_Bus_Pending(UART_HandleTypeDef *huart);
+
+/**
+ * @brief 等待串口队列全部发送完成
+ * @param timeout_ms 超时时间 (ms)
+ * @return true=已发空或串口不是电机总线, false=超时
+ */
+bool Emm_Bus_Flush(UART_HandleTypeDef *huart, uint32_t timeout_ms);
+
+/**
+ * @brief 重新启动DMA启动失败后停在队首的帧
+ * @note 在主循环中周期调用 (Motor_Background_Process已包含)
+ */
+void Emm_Bus_Process(void);
+
+/**
+ * @brief 获取串口发送统计
+ * @return 统计数据, 串口未被管理时返回NULL
+ */
+const EmmBusStats_t *Emm_Bus_Get_Stats(UART_HandleTypeDef *huart);
+
+/**
+ * @brief 组帧: 位置模式控制 (与Emm_V5_Pos_Control格式一致)
+ * @param buf 至少EMM_POS_FRAME_LEN字节
+ * @return 帧长度
+ */
+uint8_t Emm_Bus_Build_Pos(uint8_t *buf, uint8_t addr, uint8_t dir, uint16_t vel,
+                          uint8_t acc, uint32_t clk, bool raF, bool snF);
+
+/**
+ * @brief 组帧: 速度模式控制 (与Emm_V5_Vel_Control格式一致)
+ * @param buf 至少EMM_VEL_FRAME_LEN字节
+ * @return 帧长度
+ */
+uint8_t Emm_Bus_Build_Vel(uint8_t *buf, uint8_t addr, uint8_t dir, uint16_t vel,
+                          uint8_t acc, bool snF);
+
+/**
+ * @brief 组帧: 多机同步运动触发 (与Emm_V5_Synchronous_motion格式一致)
+ * @param buf 至少EMM_SYNC_FRAME_LEN字节
+ * @return 帧长度
+ */
+uint8_t Emm_Bus_Build_Sync(uint8_t *buf, uint8_t addr);
+
+/**
+ * @brief 组帧: 读取系统参数 (与Emm_V5_Read_Sys_Params格式一致)
+ * @param buf 至少EMM_READ_FRAME_MAX字节
+ * @return 帧长度, 参数无效时返回0
+ */
+uint8_t Emm_Bus_Build_Read(uint8_t *buf, uint8_t addr, SysParams_t s);
+
+/**
+ * @brief 多轴同步位置运动: 全部位置帧(snF=1)与广播同步帧打包为一次DMA突发
+ * @param huart 目标串口
+ * @param cmds  各轴位置命令
+ * @param count 轴数, 不超过EMM_BUS_BURST_MAX_AXES
+ * @return true=已入队, false=参数错误或背压超时
+ * @note 帧间无间隙, 各驱动器收到同一同步帧后同时启动
+ */
+bool Emm_Bus_Sync_Pos_Burst(UART_HandleTypeDef *huart, const EmmPosCmd_t *cmds, uint8_t count);
+
+/**
+ * @brief 多轴同步位置运动, 各轴按路由分组, 每路串口各发一次突发
+ * @return true=全部入队, false=参数错误或任一串口背压超时 (此时任何串口都未发送)
+ * @note 先在所有串口上申请帧槽, 全部成功后才一起入队, 不会只触发部分串口;
+ *       各串口的突发几乎同时启动DMA, 组内同步与单总线相同;
+ *       组间偏差为各组突发长度之差对应的线上时间
+ */
+bool Emm_Bus_Sync_Pos_Routed(const EmmPosCmd_t *cmds, uint8_t count);
+
+/**
+ * @brief 多轴同步速度设定: 全部速度帧(snF=1)与广播同步帧打包为一次DMA突发
+ * @param count 轴数, 不超过EMM_BUS_BURST_MAX_AXES
+ * @return true=已入队, false=参数错误或背压超时
+ */
+bool Emm_Bus_Sync_Vel_Burst(UART_HandleTypeDef *huart, const EmmVelCmd_t *cmds, uint8_t count);
+
+/**
+ * @brief 多轴同步速度设定, 各轴按路由分组, 每路串口各发一次突发
+ * @return true=全部入队, false=参数错误或任一串口背压超时 (此时任何串口都未发送)
+ */
+bool Emm_Bus_Sync_Vel_Routed(const EmmVelCmd_t *cmds, uint8_t count);
+
+/**
+ * @brief DMA发送完成处理, 启动队列中的下一帧
+ * @note 由HAL_UART_TxCpltCallback()调用 (hal_callbacks.c)
+ */
+void Emm_Bus_TxCpltCallback(UART_HandleTypeDef *huart);
+
+#endif /* __EMM_BUS_H */
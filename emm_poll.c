@@ -0,0 +1,258 @@
+/**
+  ******************************************************************************
+  * @file    emm_poll.c
+  * @brief   Emm_V5电机遥测轮询实现
+  ******************************************************************************
+  */
+
+#include "emm_poll.h"
+#include <string.h>
+
+/* ==================== 私有类型 ==================== */
+
+typedef struct {
+    uint8_t  addr;
+    uint8_t  param;             // SysParams_t
+    uint16_t period_ms;
+    uint32_t next_due;
+    uint32_t sent_tick;
+    uint8_t  sent_seq;          // 发出时的参数更新计数
+    bool     pending;
+} PollEntry_t;
+
+typedef struct {
+    UART_HandleTypeDef *huart;
+    uint32_t budget;            // 字节/秒
+    uint32_t tokens_milli;      // 令牌 (千分之一字节)
+    uint32_t last_tick;
+} PollBudget_t;
+
+/* ==================== 私有变量 ==================== */
+
+static PollEntry_t   s_entry[EMM_POLL_MAX_ENTRIES];
+static uint8_t       s_entry_count = 0;
+static uint8_t       s_rr = 0;
+static PollBudget_t  s_budget[EMM_BUS_MAX_UART];
+static uint8_t       s_budget_count = 0;
+static bool          s_enabled = true;
+static EmmPollStats_t s_stats;
+
+/* ==================== 私有函数 ==================== */
+
+static uint32_t default_budget(const UART_HandleTypeDef *huart)
+{
+    // 1起始位 + 8数据位 + 1停止位
+    return huart->Init.BaudRate / 10U * EMM_POLL_BUDGET_PCT / 100U;
+}
+
+static PollBudget_t *find_budget(UART_HandleTypeDef *huart)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_budget_count; i++) {
+        if (s_budget[i].huart == huart) {
+            return &s_budget[i];
+        }
+    }
+    if (s_budget_count < EMM_BUS_MAX_UART) {
+        PollBudget_t *b = &s_budget[s_budget_count++];
+        b->huart = huart;
+        b->budget = default_budget(huart);
+        b->tokens_milli = EMM_POLL_BURST_BYTES * 1000U;
+        b->last_tick = HAL_GetTick();
+        return b;
+    }
+    return NULL;
+}
+
+static void budget_refill(PollBudget_t *b, uint32_t now)
+{
+    uint32_t dt = now - b->last_tick;
+    uint32_t fill_ms = EMM_POLL_BURST_BYTES * 1000U / (b->budget ? b->budget : 1U) + 1U;
+
+    b->last_tick = now;
+    if (dt > fill_ms) {
+        dt = fill_ms;                       // 长时间未调用: 超过装满令牌桶的时间不再累计, 乘积不会溢出
+    }
+    b->tokens_milli += dt * b->budget;      // budget字节/秒 = budget毫字节/毫秒
+    if (b->tokens_milli > EMM_POLL_BURST_BYTES * 1000U) {
+        b->tokens_milli = EMM_POLL_BURST_BYTES * 1000U;
+    }
+}
+
+/**
+ * @brief 一次读取占用的总线字节数 (请求 + 回复)
+ */
+static uint8_t read_cost(uint8_t param)
+{
+    switch (param) {
+        case S_CPOS: case S_TPOS: case S_PERR: return 3 + 8;
+        case S_VEL:                            return 3 + 6;
+        case S_VBUS:                           return 3 + 5;
+        default:                               return 3 + 4;
+    }
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Emm_Poll_Init(void)
+{
+    memset(s_entry, 0, sizeof(s_entry));
+    memset(s_budget, 0, sizeof(s_budget));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_entry_count = 0;
+    s_budget_count = 0;
+    s_rr = 0;
+    s_enabled = true;
+}
+
+uint8_t Emm_Poll_Config(uint8_t addr, SysParams_t s, uint16_t rate_hz)
+{
+    uint8_t i;
+    PollEntry_t *e = NULL;
+
+    for (i = 0; i < s_entry_count; i++) {
+        if (s_entry[i].addr == addr && s_entry[i].param == (uint8_t)s) {
+            e = &s_entry[i];
+            break;
+        }
+    }
+    if (e == NULL) {
+        if (rate_hz == 0) {
+            return 0;
+        }
+        if (s_entry_count >= EMM_POLL_MAX_ENTRIES) {
+            return 1;
+        }
+        e = &s_entry[s_entry_count++];
+        e->addr = addr;
+        e->param = (uint8_t)s;
+        e->pending = false;
+    }
+
+    e->period_ms = rate_hz ? (uint16_t)(1000U / rate_hz) : 0;
+    if (e->period_ms == 0 && rate_hz != 0) {
+        e->period_ms = 1;
+    }
+    e->next_due = HAL_GetTick();
+    find_budget(Emm_Bus_Route(addr));
+    return 0;
+}
+
+void Emm_Poll_Set_Budget(UART_HandleTypeDef *huart, uint32_t bytes_per_sec)
+{
+    PollBudget_t *b = find_budget(huart);
+
+    if (b != NULL) {
+        b->budget = bytes_per_sec ? bytes_per_sec : default_budget(huart);
+    }
+}
+
+void Emm_Poll_Enable(bool enable)
+{
+    s_enabled = enable;
+}
+
+void Emm_Poll_Process(void)
+{
+    uint32_t now;
+    uint8_t sent = 0;
+    uint8_t n, i;
+
+    if (!s_enabled || s_entry_count == 0) {
+        return;
+    }
+    now = HAL_GetTick();
+
+    for (i = 0; i < s_budget_count; i++) {
+        budget_refill(&s_budget[i], now);
+    }
+
+    // 回复检查
+    for (i = 0; i < s_entry_count; i++) {
+        PollEntry_t *e = &s_entry[i];
+        if (!e->pending) {
+            continue;
+        }
+        if (Emm_Rx_Param_Seq(e->addr, (SysParams_t)e->param) != e->sent_seq) {
+            e->pending = false;
+            s_stats.replies++;
+        } else if (now - e->sent_tick > EMM_POLL_REPLY_TIMEOUT_MS) {
+            e->pending = false;
+            s_stats.missed++;
+        }
+    }
+
+    // 轮转查找到期项
+    for (n = 0; n < s_entry_count && sent < EMM_POLL_MAX_PER_CALL; n++) {
+        PollEntry_t *e = &s_entry[s_rr];
+        UART_HandleTypeDef *huart;
+        PollBudget_t *b;
+        uint8_t cost, len;
+        uint8_t frame[EMM_READ_FRAME_MAX];
+
+        s_rr = (uint8_t)((s_rr + 1U) % s_entry_count);
+
+        if (e->period_ms == 0 || e->pending || (int32_t)(now - e->next_due) < 0) {
+            continue;
+        }
+
+        huart = Emm_Bus_Route(e->addr);
+        if (Emm_Bus_Pending(huart) != 0) {
+            s_stats.deferred_motion++;      // 总线上有命令待发, 不插队
+            continue;
+        }
+        b = find_budget(huart);
+        cost = read_cost(e->param);
+        if (b == NULL || b->tokens_milli < cost * 1000U) {
+            s_stats.deferred_budget++;
+            continue;
+        }
+        if (!Emm_Rx_Read_Begin(e->addr, (SysParams_t)e->param, EMM_POLL_REPLY_TIMEOUT_MS)) {
+            s_stats.deferred_reply++;       // 该路上一个读取尚未回复, 回复会在RX线上冲突
+            continue;
+        }
+        len = Emm_Bus_Build_Read(frame, e->addr, (SysParams_t)e->param);
+        e->sent_seq = Emm_Rx_Param_Seq(e->addr, (SysParams_t)e->param);
+        if (len == 0 || !Emm_Bus_TrySend(huart, frame, len)) {
+            Emm_Rx_Read_Cancel(e->addr);
+            s_stats.deferred_motion++;
+            continue;
+        }
+
+        b->tokens_milli -= cost * 1000U;
+        e->pending = true;
+        e->sent_tick = now;
+        e->next_due += e->period_ms;
+        if ((int32_t)(now - e->next_due) > 0) {
+            e->next_due = now + e->period_ms;   // 落后时不追赶, 避免突发
+        }
+        s_stats.sent++;
+        sent++;
+    }
+}
+
+bool Emm_Poll_Get(uint8_t addr, EmmTelemetry_t *out)
+{
+    EmmRxSlot_t slot;
+    uint32_t now;
+
+    if (!Emm_Rx_Get(addr, &slot)) {
+        return false;
+    }
+    now = HAL_GetTick();
+    out->pos_deg = EMM_COUNTS_TO_DEG(slot.cpos);
+    out->perr_deg = EMM_COUNTS_TO_DEG(slot.perr);
+    out->vel_rpm = slot.vel_rpm;
+    out->flags = slot.flags;
+    out->pos_age_ms = now - slot.param_tick[S_CPOS];
+    out->perr_age_ms = now - slot.param_tick[S_PERR];
+    out->vel_age_ms = now - slot.param_tick[S_VEL];
+    out->flags_age_ms = now - slot.param_tick[S_FLAG];
+    return true;
+}
+
+const EmmPollStats_t *Emm_Poll_Get_Stats(void)
+{
+    return &s_stats;
+}
@@ -0,0 +1,96 @@
+/**
+  ******************************************************************************
+  * @file    emm_poll.h
+  * @brief   Emm_V5电机遥测轮询头文件
+  * @details 后台按配置频率轮流读取各电机的 S_CPOS/S_VEL/S_PERR/S_FLAG:
+  *          - 每路串口按字节预算(令牌桶)限制遥测流量
+  *          - 发送队列中有待发命令时不插入读取, 运动命令不会被遥测推迟
+  *          - 每路串口同一时刻只有一个读取等待回复 (Emm_Rx_Read_Begin), 回复不会冲突
+  *          - 回复由emm_rx按地址写入, Emm_Poll_Get无锁读取最新值
+  *          Emm_Poll_Process()需在主循环及各等待循环中周期调用
+  ******************************************************************************
+  */
+
+#ifndef __EMM_POLL_H
+#define __EMM_POLL_H
+
+#include "emm_bus.h"
+#include "emm_rx.h"
+
+/* ==================== 配置参数 ==================== */
+
+#define EMM_POLL_MAX_ENTRIES        24      // 最多轮询项 (地址 x 参数)
+#define EMM_POLL_BUDGET_PCT         30      // 遥测可占用的串口带宽 (%)
+#define EMM_POLL_BURST_BYTES        64      // 令牌桶容量 (字节)
+#define EMM_POLL_MAX_PER_CALL       4       // 单次调用最多发出的读取
+#define EMM_POLL_REPLY_TIMEOUT_MS   20      // 超过该时间无回复计为丢失
+
+/* ==================== 类型定义 ==================== */
+
+/**
+ * @brief 单个电机的最新遥测值 (工程单位)
+ */
+typedef struct {
+    float    pos_deg;       // 实时位置 (度, 电机轴)
+    float    perr_deg;      // 位置误差 (度)
+    int16_t  vel_rpm;       // 实时转速 (RPM)
+    uint8_t  flags;         // S_FLAG
+    uint32_t pos_age_ms;    // 各项距其最近一次更新的时间 (ms)
+    uint32_t perr_age_ms;
+    uint32_t vel_age_ms;
+    uint32_t flags_age_ms;
+} EmmTelemetry_t;
+
+/**
+ * @brief 轮询统计
+ */
+typedef struct {
+    uint32_t sent;              // 已发出读取
+    uint32_t replies;           // 按时收到回复
+    uint32_t missed;            // 回复超时
+    uint32_t deferred_motion;   // 因发送队列有命令而推迟
+    uint32_t deferred_budget;   // 因字节预算不足而推迟
+    uint32_t deferred_reply;    // 因同一路串口上一个读取尚未回复而推迟
+} EmmPollStats_t;
+
+/* ==================== 公开函数声明 ==================== */
+
+/**
+ * @brief 初始化轮询器, 清空全部轮询项
+ */
+void Emm_Poll_Init(void);
+
+/**
+ * @brief 配置某电机某参数的轮询频率
+ * @param addr 电机地址
+ * @param s 参数 (S_CPOS/S_VEL/S_PERR/S_FLAG等)
+ * @param rate_hz 轮询频率(Hz), 0表示停止轮询该项
+ * @return 0=成功, 1=轮询项已满
+ */
+uint8_t Emm_Poll_Config(uint8_t addr, SysParams_t s, uint16_t rate_hz);
+
+/**
+ * @brief 设置串口的遥测字节预算
+ * @param bytes_per_sec 每秒可用字节数 (请求+回复), 0表示恢复默认值
+ */
+void Emm_Poll_Set_Budget(UART_HandleTypeDef *huart, uint32_t bytes_per_sec);
+
+/**
+ * @brief 暂停/恢复轮询
+ */
+void Emm_Poll_Enable(bool enable);
+
+/**
+ * @brief 轮询调度, 在主循环及等待循环中调用
+ */
+void Emm_Poll_Process(void);
+
+/**
+ * @brief 读取电机最新遥测值
+ * @return true=该地址有效
+ */
+bool Emm_Poll_Get(uint8_t addr, EmmTelemetry_t *out);
+
+const EmmPollStats_t *Emm_Poll_Get_Stats(void);
+
+#endif /* __EMM_POLL_H */
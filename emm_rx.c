@@ -0,0 +1,432 @@
+/**
+  ******************************************************************************
+  * @file    emm_rx.c
+  * @brief   Emm_V5驱动器回复解析实现
+  ******************************************************************************
+  */
+
+#include "emm_rx.h"
+#include "emm_bus.h"
+#include <string.h>
+
+/* ==================== 私有类型 ==================== */
+
+typedef struct {
+    __IO uint32_t seq;      // 写入时为奇数
+    EmmRxSlot_t   data;
+} EmmRxSlotSync_t;
+
+/**
+ * @brief 单路电机串口的接收通道, 各路独立解析互不干扰
+ */
+typedef struct {
+    UART_HandleTypeDef *huart;
+    uint8_t  dma_buf[EMM_RX_DMA_BUF_SIZE];
+    uint16_t dma_pos;                   // 已解析到的DMA缓冲区位置
+    uint8_t  frame[EMM_RX_FRAME_MAX];   // 尚未组成完整帧的字节
+    uint8_t  frame_len;
+    __IO bool rd_busy;                  // 有读取等待回复, 同一路串口同一时刻只允许一个
+    uint8_t  rd_addr;                   // 等待回复的读取: 地址/参数/截止时刻
+    uint8_t  rd_param;
+    uint32_t rd_deadline;
+    __IO bool rd_stale;                 // 读取发出后该电机又下发了运动命令, S_FLAG到位位属于上一次运动
+} EmmRxChan_t;
+
+/* ==================== 私有变量 ==================== */
+
+static EmmRxChan_t     s_chan[EMM_RX_MAX_UART];
+static uint8_t         s_chan_count = 0;
+
+static EmmRxSlotSync_t s_slot[EMM_RX_MAX_ADDR];
+static EmmRxStats_t    s_stats;
+static __IO uint32_t   s_arrived_mask = 0;
+static __IO uint32_t   s_stall_mask = 0;
+
+/* ==================== 私有函数 ==================== */
+
+/**
+ * @brief 功能码 -> 读取参数类型
+ * @return 对应SysParams_t, 非读取命令返回-1
+ */
+static int8_t func_to_param(uint8_t func)
+{
+    switch (func) {
+        case 0x1F: return S_VER;
+        case 0x20: return S_RL;
+        case 0x21: return S_PID;
+        case 0x24: return S_VBUS;
+        case 0x27: return S_CPHA;
+        case 0x31: return S_ENCL;
+        case 0x33: return S_TPOS;
+        case 0x35: return S_VEL;
+        case 0x36: return S_CPOS;
+        case 0x37: return S_PERR;
+        case 0x3A: return S_FLAG;
+        case 0x3B: return S_ORG;
+        case 0x42: return S_Conf;
+        case 0x43: return S_State;
+        default:   return -1;
+    }
+}
+
+/**
+ * @brief 根据已收到的字节确定回复帧总长度
+ * @return 帧长度, 0表示还需要更多字节才能确定
+ */
+static uint8_t reply_len(const uint8_t *f, uint8_t have)
+{
+    switch (f[1]) {
+        case 0x36: case 0x33: case 0x37: return 8;    // 地址 功能码 符号 4字节 校验
+        case 0x35:                       return 6;    // 地址 功能码 符号 2字节 校验
+        case 0x24: case 0x27: case 0x31:
+        case 0x1F:                       return 5;
+        case 0x20:                       return 7;
+        case 0x21:                       return 15;
+        case 0x3A: case 0x3B:            return 4;
+        case 0x42: case 0x43:            // 第3字节为帧总长度
+            return (have >= 3) ? f[2] : 0;
+        default:                         return 4;    // 命令应答/到位返回: 地址 功能码 状态 校验
+    }
+}
+
+static int32_t be32_signed(const uint8_t *p)
+{
+    uint32_t v = ((uint32_t)p[1] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 8) | p[4];
+    return p[0] ? -(int32_t)v : (int32_t)v;
+}
+
+/**
+ * @brief 完整帧: 解码并写入对应地址槽
+ */
+static void frame_dispatch(EmmRxChan_t *c, const uint8_t *f, uint8_t len)
+{
+    uint8_t addr = f[0];
+    int8_t param = func_to_param(f[1]);
+    EmmRxSlot_t *d;
+
+    s_stats.frames++;
+
+    // 旧接口: 保留整帧与到位标志, 供尚未迁移的代码使用
+    memcpy((void *)rxCmd, f, len);
+    rxCount = len;
+    rxFrameFlag = true;
+    if (len == 4 && f[1] == 0xFD && f[2] == 0x9F) {
+        motor_arrived_flag = true;
+    }
+
+    if (addr >= EMM_RX_MAX_ADDR) {
+        s_stats.unknown_addr++;
+        return;
+    }
+
+    s_slot[addr].seq++;
+    d = &s_slot[addr].data;
+    switch (param) {
+        case S_CPOS: d->cpos = be32_signed(&f[2]); break;
+        case S_TPOS: d->tpos = be32_signed(&f[2]); break;
+        case S_PERR: d->perr = be32_signed(&f[2]); break;
+        case S_VEL:
+            d->vel_rpm = (int16_t)(((uint16_t)f[3] << 8) | f[4]);
+            if (f[2]) d->vel_rpm = (int16_t)-d->vel_rpm;
+            break;
+        case S_VBUS: d->vbus_mv = (uint16_t)(((uint16_t)f[2] << 8) | f[3]); break;
+        case S_FLAG:
+            d->flags = f[2];
+            if (f[2] & (EMM_FLAG_STALLED | EMM_FLAG_STALL_PROT)) {
+                s_stall_mask |= EMM_ADDR_MASK(addr);
+            } else if ((f[2] & EMM_FLAG_IN_POSITION) && c->rd_busy && !c->rd_stale &&
+                       c->rd_addr == addr && c->rd_param == (uint8_t)S_FLAG) {
+                // 到位返回可能与同一路其他驱动器的回复冲突而丢失, 以读到的到位位补上
+                s_arrived_mask |= EMM_ADDR_MASK(addr);
+            }
+            break;
+        case S_ORG:  d->org = f[2]; break;
+        case -1:
+            d->ack_func = f[1];
+            d->ack_status = f[2];
+            if (f[1] == 0xFD && f[2] == 0x9F) {
+                s_arrived_mask |= EMM_ADDR_MASK(addr);
+            } else if ((f[1] == 0xFD || f[1] == 0xF6) && f[2] == 0xE2) {
+                // 运动命令被拒绝 (堵转保护中或未使能), 该电机不会再到位
+                s_stall_mask |= EMM_ADDR_MASK(addr);
+            }
+            break;
+        default:
+            break;
+    }
+    d->tick = HAL_GetTick();
+    if (param >= 0) {
+        d->param_seq[param]++;
+        d->param_tick[param] = d->tick;
+        if (c->rd_busy && c->rd_addr == addr && c->rd_param == (uint8_t)param) {
+            c->rd_busy = false;
+        }
+    }
+    s_slot[addr].seq++;
+}
+
+/**
+ * @brief 追加一个字节并从头扫描缓冲区中的候选帧
+ * @note 帧长/帧尾错误时扫描位置只前移一个字节, 其后的字节原地重新解析,
+ *       不递归、不复制, 中断中栈占用固定; 扫描结束后未成帧的字节移到缓冲区开头
+ */
+static void parse_byte(EmmRxChan_t *c, uint8_t b)
+{
+    uint8_t start = 0;
+
+    c->frame[c->frame_len++] = b;
+
+    while (start < c->frame_len) {
+        const uint8_t *f = &c->frame[start];
+        uint8_t avail = (uint8_t)(c->frame_len - start);
+        uint8_t need;
+
+        if (f[0] == 0x6B) {
+            start++;            // 残留校验字节
+            continue;
+        }
+        if (avail < 3U) {
+            break;              // 地址 功能码 + 1字节后才能确定帧长
+        }
+        need = reply_len(f, avail);
+        if (need == 0) {
+            break;
+        }
+        if (need < 4 || need > EMM_RX_FRAME_MAX) {
+            s_stats.resync++;
+            start++;
+            continue;
+        }
+        if (avail < need) {
+            break;
+        }
+        if (f[need - 1U] == 0x6B) {
+            frame_dispatch(c, f, need);
+            start = (uint8_t)(start + need);
+        } else {
+            s_stats.resync++;   // 帧尾错误: 丢弃首字节
+            start++;
+        }
+    }
+
+    if (start != 0) {
+        c->frame_len = (uint8_t)(c->frame_len - start);
+        memmove(c->frame, &c->frame[start], c->frame_len);
+    }
+}
+
+static void rx_start(EmmRxChan_t *c)
+{
+    c->dma_pos = 0;
+    c->frame_len = 0;
+    c->rd_busy = false;
+    HAL_UARTEx_ReceiveToIdle_DMA(c->huart, c->dma_buf, EMM_RX_DMA_BUF_SIZE);
+}
+
+static EmmRxChan_t *find_chan(const UART_HandleTypeDef *huart)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_chan_count; i++) {
+        if (s_chan[i].huart == huart) {
+            return &s_chan[i];
+        }
+    }
+    return NULL;
+}
+
+static void feed(EmmRxChan_t *c, const uint8_t *data, uint16_t len)
+{
+    uint16_t i;
+
+    for (i = 0; i < len; i++) {
+        parse_byte(c, data[i]);
+    }
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Emm_Rx_Init(UART_HandleTypeDef *huart)
+{
+    EmmRxChan_t *c = find_chan(huart);
+
+    if (s_chan_count == 0) {
+        memset(s_slot, 0, sizeof(s_slot));
+        memset(&s_stats, 0, sizeof(s_stats));
+        s_arrived_mask = 0;
+        s_stall_mask = 0;
+    }
+    if (c == NULL) {
+        if (s_chan_count >= EMM_RX_MAX_UART) {
+            return;
+        }
+        c = &s_chan[s_chan_count++];
+        c->huart = huart;
+    }
+    rx_start(c);
+}
+
+void Emm_Rx_Feed(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len)
+{
+    EmmRxChan_t *c = find_chan(huart);
+
+    if (c != NULL) {
+        feed(c, data, len);
+    }
+}
+
+bool Emm_Rx_Get(uint8_t addr, EmmRxSlot_t *out)
+{
+    uint32_t seq;
+
+    if (addr >= EMM_RX_MAX_ADDR) {
+        return false;
+    }
+    do {
+        seq = s_slot[addr].seq;
+        memcpy(out, &s_slot[addr].data, sizeof(*out));
+    } while ((seq & 1U) || seq != s_slot[addr].seq);
+    return true;
+}
+
+uint8_t Emm_Rx_Param_Seq(uint8_t addr, SysParams_t s)
+{
+    if (addr >= EMM_RX_MAX_ADDR || (uint8_t)s >= EMM_RX_PARAM_COUNT) {
+        return 0;
+    }
+    return s_slot[addr].data.param_seq[s];
+}
+
+bool Emm_Rx_Wait_Param(uint8_t addr, SysParams_t s, uint8_t seq, uint32_t timeout_ms)
+{
+    uint32_t tickstart = HAL_GetTick();
+
+    while (Emm_Rx_Param_Seq(addr, s) == seq) {
+        if (HAL_GetTick() - tickstart > timeout_ms) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Emm_Rx_Read_Begin(uint8_t addr, SysParams_t s, uint32_t timeout_ms)
+{
+    EmmRxChan_t *c = find_chan(Emm_Bus_Route(addr));
+    uint32_t now = HAL_GetTick();
+
+    if (c == NULL) {
+        return true;                // 该串口未启动接收, 不会有回复冲突
+    }
+    __disable_irq();
+    if (c->rd_busy && (int32_t)(now - c->rd_deadline) < 0) {
+        __enable_irq();
+        return false;
+    }
+    c->rd_busy = true;
+    c->rd_addr = addr;
+    c->rd_param = (uint8_t)s;
+    c->rd_deadline = now + timeout_ms;
+    c->rd_stale = false;
+    __enable_irq();
+    return true;
+}
+
+void Emm_Rx_Read_Cancel(uint8_t addr)
+{
+    EmmRxChan_t *c = find_chan(Emm_Bus_Route(addr));
+
+    if (c != NULL && c->rd_addr == addr) {
+        c->rd_busy = false;
+    }
+}
+
+bool Emm_Read_Param(uint8_t addr, SysParams_t s, uint32_t timeout_ms, EmmRxSlot_t *out)
+{
+    uint32_t tickstart = HAL_GetTick();
+    uint8_t seq;
+
+    // 等待同一路串口上的前一个读取回复或超时, 两个驱动器同时回复会在RX线上冲突
+    while (!Emm_Rx_Read_Begin(addr, s, timeout_ms)) {
+        if (HAL_GetTick() - tickstart > timeout_ms) {
+            return false;
+        }
+    }
+    seq = Emm_Rx_Param_Seq(addr, s);
+    Emm_V5_Read_Sys_Params(addr, s);
+    if (!Emm_Rx_Wait_Param(addr, s, seq, timeout_ms)) {
+        return false;
+    }
+    if (out != NULL) {
+        Emm_Rx_Get(addr, out);
+    }
+    return true;
+}
+
+const EmmRxStats_t *Emm_Rx_Get_Stats(void)
+{
+    return &s_stats;
+}
+
+void Emm_Rx_Arm_Arrival(uint32_t mask)
+{
+    uint8_t i;
+
+    __disable_irq();
+    s_arrived_mask &= ~mask;
+    for (i = 0; i < s_chan_count; i++) {
+        if (s_chan[i].rd_busy && (mask & EMM_ADDR_MASK(s_chan[i].rd_addr))) {
+            s_chan[i].rd_stale = true;
+        }
+    }
+    __enable_irq();
+}
+
+uint32_t Emm_Rx_Arrived_Mask(void)
+{
+    return s_arrived_mask;
+}
+
+uint32_t Emm_Rx_Stall_Mask(void)
+{
+    return s_stall_mask;
+}
+
+void Emm_Rx_Clear_Stall(uint32_t mask)
+{
+    __disable_irq();
+    s_stall_mask &= ~mask;
+    __enable_irq();
+}
+
+void Emm_Rx_EventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    EmmRxChan_t *c = find_chan(huart);
+
+    if (c == NULL || Size > EMM_RX_DMA_BUF_SIZE) {
+        return;
+    }
+
+    // 循环缓冲区: 只解析 [dma_pos, Size) 的新字节
+    if (Size != c->dma_pos) {
+        if (Size > c->dma_pos) {
+            feed(c, &c->dma_buf[c->dma_pos], (uint16_t)(Size - c->dma_pos));
+        } else {
+            feed(c, &c->dma_buf[c->dma_pos], (uint16_t)(EMM_RX_DMA_BUF_SIZE - c->dma_pos));
+            feed(c, &c->dma_buf[0], Size);
+        }
+        c->dma_pos = Size;
+    }
+    if (c->dma_pos >= EMM_RX_DMA_BUF_SIZE) {
+        c->dma_pos = 0;
+    }
+}
+
+void Emm_Rx_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    EmmRxChan_t *c = find_chan(huart);
+
+    if (c != NULL) {
+        HAL_UART_AbortReceive(huart);
+        rx_start(c);
+    }
+}
@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file    emm_rx.h
+  * @brief   Emm_V5驱动器回复解析头文件
+  * @details 电机串口以DMA循环模式+IDLE中断接收, 逐字节状态机解析回复帧,
+  *          按驱动器地址分发到独立的数据槽并解码为对应的参数值:
+  *          - 不同驱动器的回复写入各自的数据槽, 互不覆盖
+  *          - 同一路串口上的驱动器共用一根RX线, 同时回复会冲突;
+  *            读取须经Emm_Rx_Read_Begin占用该路, 每路同一时刻只有一个读取等待回复
+  *          - 每路电机串口一个独立的接收通道, 数据槽按地址全局共享
+  *          - 读取者通过序号检测更新, 不需要清除标志
+  *          - 同时维护旧接口 rxCmd/rxCount/rxFrameFlag/motor_arrived_flag
+  ******************************************************************************
+  */
+
+#ifndef __EMM_RX_H
+#define __EMM_RX_H
+
+#include "usart.h"
+#include "Emm_V5.h"
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+#define EMM_RX_DMA_BUF_SIZE     128     // 每路DMA循环接收缓冲区 (字节)
+#define EMM_RX_MAX_UART         3       // 最多接收通道 (电机串口) 数
+#define EMM_RX_MAX_ADDR         8       // 地址槽数量, 覆盖地址 0~7
+#define EMM_RX_FRAME_MAX        32      // 单帧最大长度
+#define EMM_RX_PARAM_COUNT      17      // SysParams_t 取值范围 0~16
+
+// 位置/误差读数单位: 65536 对应一圈
+#define EMM_COUNTS_PER_REV      65536
+#define EMM_COUNTS_TO_DEG(c)    ((float)(c) * 360.0f / (float)EMM_COUNTS_PER_REV)
+
+// S_FLAG 标志位
+#define EMM_FLAG_ENABLED        0x01    // 电机使能
+#define EMM_FLAG_IN_POSITION    0x02    // 电机到位
+#define EMM_FLAG_STALLED        0x04    // 电机堵转
+#define EMM_FLAG_STALL_PROT     0x08    // 堵转保护已触发
+
+// S_ORG 标志位
+#define EMM_ORG_ENC_READY       0x01    // 编码器就绪
+#define EMM_ORG_CAL_READY       0x02    // 校准表就绪
+#define EMM_ORG_HOMING          0x04    // 正在回零
+#define EMM_ORG_HOME_FAILED     0x08    // 回零失败
+
+// 驱动器地址 -> 位掩码位
+#define EMM_ADDR_MASK(addr)     (1UL << (addr))
+
+/* ==================== 类型定义 ==================== */
+
+/**
+ * @brief 单个驱动器的最新回复数据
+ */
+typedef struct {
+    int32_t  cpos;          // S_CPOS 实时位置 (65536/圈)
+    int32_t  tpos;          // S_TPOS 目标位置 (65536/圈)
+    int32_t  perr;          // S_PERR 位置误差 (65536/圈)
+    int16_t  vel_rpm;       // S_VEL  实时转速 (RPM)
+    uint16_t vbus_mv;       // S_VBUS 总线电压 (mV)
+    uint8_t  flags;         // S_FLAG 使能/到位/堵转
+    uint8_t  org;           // S_ORG  回零状态
+    uint8_t  ack_func;      // 最近一次命令应答的功能码
+    uint8_t  ack_status;    // 最近一次命令应答状态 (0x02=成功 0xE2=条件不满足 0xEE=错误)
+    uint32_t tick;          // 最近一次收到任意回复的时刻 (HAL_GetTick)
+    uint8_t  param_seq[EMM_RX_PARAM_COUNT]; // 各参数的更新计数
+    uint32_t param_tick[EMM_RX_PARAM_COUNT];// 各参数最近一次更新的时刻, 计算单项数据的时效用此值
+} EmmRxSlot_t;
+
+/**
+ * @brief 解析器统计
+ */
+typedef struct {
+    uint32_t frames;        // 完整帧数
+    uint32_t resync;        // 帧尾错误后重新同步次数
+    uint32_t unknown_addr;  // 超出地址槽范围的帧
+} EmmRxStats_t;
+
+/* ==================== 公开函数声明 ==================== */
+
+/**
+ * @brief 启动一路电机串口的DMA循环接收
+ * @param huart 电机总线串口 (其RX DMA须配置为DMA_CIRCULAR)
+ * @note 每路电机串口调用一次 (见Emm_Bus_Uart_List), 重复调用将重新启动该路接收
+ */
+void Emm_Rx_Init(UART_HandleTypeDef *huart);
+
+/**
+ * @brief 向某路接收通道的解析状态机输入字节
+ * @note 通常由接收事件回调调用, 也可用于离线回放
+ */
+void Emm_Rx_Feed(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 读取某驱动器最新数据的一致性快照
+ * @param addr 驱动器地址
+ * @param out  输出快照
+ * @return true=成功, false=地址超出范围
+ */
+bool Emm_Rx_Get(uint8_t addr, EmmRxSlot_t *out);
+
+/**
+ * @brief 获取某参数的更新计数, 配合Emm_Rx_Wait_Param检测新回复
+ */
+uint8_t Emm_Rx_Param_Seq(uint8_t addr, SysParams_t s);
+
+/**
+ * @brief 等待参数在seq之后的新回复
+ * @param seq 发起读取前由Emm_Rx_Param_Seq()获得
+ * @return true=已更新, false=超时
+ */
+bool Emm_Rx_Wait_Param(uint8_t addr, SysParams_t s, uint8_t seq, uint32_t timeout_ms);
+
+/**
+ * @brief 占用驱动器所在串口的读取通道, 成功后调用者立即发送读取命令
+ * @param addr 驱动器地址 (按Emm_Bus_Route确定串口)
+ * @param timeout_ms 回复超时, 超时后该路自动释放
+ * @return true=已占用, false=该路有读取正在等待回复
+ * @note 收到该地址该参数的回复时自动释放; 该路未启动接收时总是成功
+ */
+bool Emm_Rx_Read_Begin(uint8_t addr, SysParams_t s, uint32_t timeout_ms);
+
+/**
+ * @brief 读取命令未能发出时释放Emm_Rx_Read_Begin占用的读取通道
+ */
+void Emm_Rx_Read_Cancel(uint8_t addr);
+
+/**
+ * @brief 读取参数并等待回复 (Emm_Rx_Read_Begin + Emm_V5_Read_Sys_Params + 等待)
+ * @param out 输出回复后的快照, 可为NULL
+ * @return true=收到回复, false=该路一直被占用或回复超时
+ */
+bool Emm_Read_Param(uint8_t addr, SysParams_t s, uint32_t timeout_ms, EmmRxSlot_t *out);
+
+const EmmRxStats_t *Emm_Rx_Get_Stats(void);
+
+/**
+ * @brief 清除指定电机的到位位, 在下发运动命令之前调用
+ * @param mask 电机位掩码 (EMM_ADDR_MASK)
+ */
+void Emm_Rx_Arm_Arrival(uint32_t mask);
+
+/**
+ * @brief 获取到位位掩码
+ * @note 收到到位返回(地址 FD 9F 6B)时置位; 经Emm_Rx_Read_Begin发出、在Emm_Rx_Arm_Arrival
+ *       之后的S_FLAG读取回复到位位时也置位, 用于补上在RX线上冲突丢失的到位返回
+ */
+uint32_t Emm_Rx_Arrived_Mask(void);
+
+/**
+ * @brief 获取堵转位掩码
+ * @note S_FLAG回复含堵转/堵转保护位, 或运动命令被拒绝(0xE2)时置位
+ */
+uint32_t Emm_Rx_Stall_Mask(void);
+
+/**
+ * @brief 清除堵转位
+ */
+void Emm_Rx_Clear_Stall(uint32_t mask);
+
+/**
+ * @brief 接收事件处理 (DMA半满/全满/IDLE)
+ * @note 由HAL_UARTEx_RxEventCallback()调用 (hal_callbacks.c)
+ */
+void Emm_Rx_EventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+
+/**
+ * @brief 接收错误处理, 重新启动DMA接收
+ * @note 由HAL_UART_ErrorCallback()调用 (hal_callbacks.c)
+ */
+void Emm_Rx_ErrorCallback(UART_HandleTypeDef *huart);
+
+#endif /* __EMM_RX_H */
@@ -17,11 +17,18 @@
 
 // 升降电机(丝杆步进电机)配置
 #define GRIPPER_LIFT_MOTOR_ADDR     6       // 升降电机地址
+#define GRIPPER_LIFT_MASK           (1UL << GRIPPER_LIFT_MOTOR_ADDR)    // 升降电机位掩码 (Motor_Wait_All)
 #define GRIPPER_CLK_PER_MM          1143    // 脉冲数/mm (实测: 16000clk=14mm)
+#define GRIPPER_LIFT_PULSES_PER_REV 3200    // 升降驱动器每圈脉冲数 (16细分), 须与升降驱动器细分设置一致,
+                                            // 与底盘MOTOR_PULSES_PER_REV无关; 编码器读数按此换算为脉冲
 #define GRIPPER_DEFAULT_SPEED       150      // 默认速度 (RPM)
 #define GRIPPER_DEFAULT_ACC         100     // 默认加速度
 #define GRIPPER_MAX_HEIGHT          28.0f   // 最大升降高度 (mm) - 离地20.8cm
 #define GRIPPER_MIN_HEIGHT          0.0f    // 最小升降高度 (mm) - 离地18cm(零点)
+#define GRIPPER_LIFT_DIR_UP         0       // 上升方向 (0=CW 1=CCW)
+#define GRIPPER_LIFT_TIMEOUT_MS     8000    // Gripper_Lift_Wait等待超时 (ms), 全行程约5.2s
+#define GRIPPER_LIFT_TOL_MM         0.2f    // 实测高度到位容差 (mm)
+#define GRIPPER_LIFT_POLL_HZ        50      // 运动中S_CPOS轮询频率 (S_FLAG减半)
 
 // 云台舵机配置 (TIM1_CH1)
 #define GRIPPER_PAN_MIN_ANGLE       0.0f    // 云台最小角度(抓取位置)
@@ -31,6 +38,25 @@
 #define GRIPPER_CLAW_MIN_ANGLE      3.0f    // 爪子抓紧角度
 #define GRIPPER_CLAW_MAX_ANGLE      45.0f   // 爪子松开角度
 
+// 热启动回零 (gripper_home.c)
+#define GRIPPER_HOME_BKP_OFFSET     0       // 记录在备份SRAM中的偏移 (字节)
+#define GRIPPER_HOME_MODE           2       // 回零模式: 2=多圈无限位碰撞, 装有限位开关时改为3
+                                            // (0/1为单圈回零, 丝杆行程多圈不能使用)
+#define GRIPPER_HOME_DIR            (GRIPPER_LIFT_DIR_UP ^ 1)   // 回零方向: 向下
+#define GRIPPER_HOME_VEL_RPM        30      // 回零转速 (RPM)
+#define GRIPPER_HOME_SL_RPM         300     // 碰撞检测转速 (RPM), 仅模式2
+#define GRIPPER_HOME_SL_MA          800     // 碰撞检测电流 (mA), 仅模式2
+#define GRIPPER_HOME_SL_MS          60      // 碰撞检测时间 (ms), 仅模式2
+#define GRIPPER_HOME_TOL_MM         0.1f    // 驱动器位置与记录的允许偏差 (mm)
+#define GRIPPER_HOME_TIMEOUT_MS     15000   // 回零超时 (ms)
+#define GRIPPER_HOME_START_MS       500     // 触发后此时间内未见回零进行且位置未变, 判为未执行
+#define GRIPPER_HOME_POLL_MS        50      // 回零中S_ORG查询周期 (ms)
+#define GRIPPER_HOME_READ_TIMEOUT_MS 10     // 单次参数读取超时 (ms)
+
+// 动作序列 (gripper_seq.c)
+#define GRIPPER_SEQ_MAX_STEPS       16      // 单个序列最多步骤
+#define GRIPPER_SEQ_TIMEOUT_MS      15000   // 单个序列超时 (ms)
+
 /* ==================== 预设位置参数 ==================== */
 
 // 升降高度预设值 (根据比赛场地实测调整)
@@ -49,6 +75,78 @@
 #define PAN_ANGLE_PLATE2            204.0f  // 第二个物料盘位置
 #define PAN_ANGLE_PLATE3            224.0f  // 第三个物料盘位置
 
+/* ==================== 类型定义 ==================== */
+
+/**
+ * @brief 升降命令句柄, 由Gripper_Lift_Async返回
+ */
+typedef uint16_t GripperLiftHandle_t;
+
+#define GRIPPER_LIFT_HANDLE_NONE    0       // 无效句柄, 视为已完成
+
+/**
+ * @brief 升降命令状态
+ */
+typedef enum {
+    GRIPPER_LIFT_BUSY = 0,      // 运动中
+    GRIPPER_LIFT_DONE,          // 已到位
+    GRIPPER_LIFT_STALLED,       // 堵转保护
+    GRIPPER_LIFT_SUPERSEDED,    // 已被之后的升降命令取代
+    GRIPPER_LIFT_MISSED         // 驱动器报告到位, 但实测高度超出容差 (丢步)
+} GripperLiftState_t;
+
+/**
+ * @brief 升降实测状态 (编码器S_CPOS换算)
+ */
+typedef struct {
+    float    height_mm;     // 实测高度
+    float    vel_mm_s;      // 实测速度, 正值上升
+    float    target_mm;     // 命令高度
+    uint32_t age_ms;        // 实测值距今时间
+    uint8_t  flags;         // 最近一次S_FLAG
+    bool     stalled;       // 堵转/堵转保护
+} GripperLiftStatus_t;
+
+/**
+ * @brief 启动回零结果
+ */
+typedef enum {
+    GRIPPER_HOME_WARM = 0,      // 记录与驱动器一致, 跳过回零
+    GRIPPER_HOME_COLD,          // 已执行回零
+    GRIPPER_HOME_FAILED         // 回零失败或超时
+} GripperHomeResult_t;
+
+/**
+ * @brief 动作序列中的执行机构
+ */
+typedef enum {
+    GRIP_ACT_LIFT = 0,          // 升降到value (mm)
+    GRIP_ACT_PAN,               // 云台转到value (度)
+    GRIP_ACT_CLAW_OPEN,         // 爪子张开
+    GRIP_ACT_CLAW_CLOSE,        // 爪子闭合
+    GRIP_ACT_WAIT               // 仅等待settle_ms
+} GripperAct_t;
+
+#define GRIP_AFTER(i)               (1UL << (i))    // 依赖第i步
+
+/**
+ * @brief 动作序列的一步
+ */
+typedef struct {
+    GripperAct_t act;
+    float        value;         // 高度(mm)或角度(度)
+    uint16_t     settle_ms;     // 舵机到位/等待时间, 0表示按舵机转速模型预测; 升降按到位判定
+    uint32_t     after;         // 依赖的步骤 (GRIP_AFTER位或), 全部完成后才启动
+} GripperStep_t;
+
+/**
+ * @brief 单步计时 (相对序列开始, ms)
+ */
+typedef struct {
+    uint16_t start_ms;
+    uint16_t end_ms;
+} GripperStepLog_t;
+
 /* ==================== 公开函数声明 ==================== */
 
 /**
@@ -58,12 +156,99 @@
  */
 void Gripper_Lift(float height_mm);
 
+/**
+ * @brief 升降到指定高度并等待结束 (gripper_lift.c, Gripper_Lift转调本函数)
+ * @param height_mm 目标高度 (mm), 范围[0, 22]
+ * @return GRIPPER_LIFT_DONE=到位; GRIPPER_LIFT_BUSY=GRIPPER_LIFT_TIMEOUT_MS内未到位(已停止);
+ *         GRIPPER_LIFT_STALLED/GRIPPER_LIFT_MISSED=堵转/丢步
+ * @note 使用默认速度GRIPPER_DEFAULT_SPEED, 等价于Gripper_Lift_Join(Gripper_Lift_Async(h)),
+ *       超时则调用Gripper_Lift_Abort. 任何结果返回时升降轮询均已关闭
+ */
+GripperLiftState_t Gripper_Lift_Wait(float height_mm);
+
+/**
+ * @brief 发起升降运动, 立即返回
+ * @param height_mm 目标高度 (mm), 超出[GRIPPER_MIN_HEIGHT, GRIPPER_MAX_HEIGHT]时限幅
+ * @return 命令句柄, 用Gripper_Lift_Poll/Gripper_Lift_Join查询
+ * @note 可在底盘行驶、云台旋转期间调用; 运动中再次调用会直接改写目标高度.
+ *       静止时目标与实测高度相差不超过GRIPPER_LIFT_TOL_MM则不下发运动;
+ *       上次命令堵转时先解除驱动器堵转保护并清除堵转位
+ */
+GripperLiftHandle_t Gripper_Lift_Async(float height_mm);
+
+/**
+ * @brief 查询升降命令状态, 不阻塞
+ * @note 运动命令之后的编码器实测高度进入GRIPPER_LIFT_TOL_MM即为完成
+ */
+GripperLiftState_t Gripper_Lift_Poll(GripperLiftHandle_t h);
+
+/**
+ * @brief 等待升降命令结束 (等待期间处理电机后台任务)
+ * @param timeout_ms 超时时间, 超时返回GRIPPER_LIFT_BUSY
+ */
+GripperLiftState_t Gripper_Lift_Join(GripperLiftHandle_t h, uint32_t timeout_ms);
+
+/**
+ * @brief 放弃仍在运动的升降命令: 停止电机并关闭升降轮询
+ * @note h已结束或已被取代时不做任何操作; 放弃后h查询为GRIPPER_LIFT_SUPERSEDED,
+ *       命令高度改为停止时的实测高度
+ */
+void Gripper_Lift_Abort(GripperLiftHandle_t h);
+
 /**
  * @brief 获取当前机械爪高度
  * @retval 当前高度 (mm)
  */
 float Gripper_Get_Height(void);
 
+/**
+ * @brief 获取升降实测高度 (gripper_lift.c, Gripper_Get_Height转调本函数)
+ * @retval 最近一次编码器实测高度 (mm); 尚无读数时返回命令高度
+ * @note 运动中自动轮询; 静止时需要最新值可先调用Gripper_Lift_Refresh
+ */
+float Gripper_Lift_Get_Height(void);
+
+/**
+ * @brief 获取最近一次升降命令的目标高度 (mm)
+ */
+float Gripper_Get_Target_Height(void);
+
+/**
+ * @brief 读取升降实测状态
+ * @return false=尚无编码器读数
+ */
+bool Gripper_Lift_Get_Status(GripperLiftStatus_t *out);
+
+/**
+ * @brief 升降S_CPOS计数换算为高度 (mm)
+ */
+float Gripper_Lift_Counts_To_Height(int32_t cpos);
+
+/**
+ * @brief 设定当前高度基准 (回零完成或热启动恢复后调用), 不产生运动
+ */
+void Gripper_Lift_Set_Reference(float height_mm);
+
+/**
+ * @brief 启动时确定升降零点: 备份SRAM记录与驱动器一致则跳过回零
+ * @param force true=忽略记录, 强制回零
+ * @return 见GripperHomeResult_t
+ * @note 替代启动时的Emm_V5_Reset_CurPos_To_Zero / Emm_V5_Origin_Trigger_Return
+ */
+GripperHomeResult_t Gripper_Home_Init(bool force);
+
+/**
+ * @brief 升降运动开始/停稳时更新备份SRAM记录 (由gripper_lift.c调用)
+ */
+void Gripper_Home_Note_Moving(void);
+void Gripper_Home_Note_Stopped(float height_mm);
+
+/**
+ * @brief 立即读取一次S_CPOS并更新实测高度
+ * @return false=超时无回复
+ */
+bool Gripper_Lift_Refresh(uint32_t timeout_ms);
+
 /**
  * @brief 控制云台旋转到指定角度
  * @param angle_deg 目标角度 (度), 范围[0, 270]
@@ -90,6 +275,31 @@ void Gripper_Claw_Close(void);
  */
 void Gripper_PickAndPlace(int plate_number);
 
+/**
+ * @brief 执行动作序列, 依赖满足的步骤立即启动, 互不依赖的步骤并行
+ * @param steps 步骤表, 依赖只能指向表内步骤
+ * @param count 步骤数, 不超过GRIPPER_SEQ_MAX_STEPS
+ * @return 0=完成, 1=步骤表错误(依赖越界或成环), 2=升降堵转, 3=超时,
+ *         4=升降丢步(驱动器到位但实测高度超差), 5=升降命令被取代(序列外或并行的升降步骤改写了目标)
+ * @note 升降步骤只有GRIPPER_LIFT_DONE才算完成, 其余结束状态立即终止序列, 后续步骤不再启动
+ */
+uint8_t Gripper_Seq_Run(const GripperStep_t *steps, uint8_t count);
+
+/**
+ * @brief 读取最近一次序列的每步计时
+ * @param log 输出计时数组指针, 下标与步骤表一致
+ * @return 步骤数
+ */
+uint8_t Gripper_Seq_Get_Log(const GripperStepLog_t **log);
+
+/**
+ * @brief 以步骤表执行抓取并放置: 闭爪后升降与云台并行, 到位后松爪
+ * @param plate_number 物料盘编号 (1/2/3)
+ * @param return_home true=松爪后云台回抓取位并同时下降到抓取高度
+ * @return 同Gripper_Seq_Run
+ */
+uint8_t Gripper_Seq_PickAndPlace(int plate_number, bool return_home);
+
 /**
  * @brief 重置抓取计数器
  * @note 在新的抓取流程开始前调用,将计数器重置为0
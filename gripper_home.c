@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+  * @file    gripper_home.c
+  * @brief   升降电机热启动回零
+  * @details 升降每次停稳后把位置与回零状态写入备份SRAM (复位不丢失, 接VBAT时断电不丢失):
+  *          - 运动开始时记为"运动中", 中途复位/堵转的记录在启动时不被采信
+  *          - 启动时读取驱动器S_ORG与S_CPOS, 驱动器未在回零、位置与记录一致时跳过回零
+  *          - 记录无效或不一致时才执行回零, 完成后重新写入记录
+  *          备份SRAM写入即RAM写入, 每次运动都可更新, 不存在Flash擦写寿命与耗时问题
+  ******************************************************************************
+  */
+
+#include "gripper.h"
+#include "motor.h"
+#include "emm_rx.h"
+#include "Emm_V5.h"
+#include "crc16.h"
+#include <math.h>
+#include <stddef.h>
+
+/* ==================== 私有类型 ==================== */
+
+#define HOME_REC_MAGIC      0x4C494654UL    // "LIFT"
+#define HOME_REC_VERSION    1
+
+typedef enum {
+    HOME_REC_IDLE = 0,      // 已停稳, height_mm有效
+    HOME_REC_MOVING         // 运动中
+} HomeRecState_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t  homed;         // 上次回零成功
+    uint8_t  state;         // HomeRecState_t
+    float    height_mm;     // 停稳时的高度
+    uint16_t crc;           // 以上字段的CRC16
+} HomeRecord_t;
+
+/* ==================== 私有变量 ==================== */
+
+static HomeRecord_t *const s_rec = (HomeRecord_t *)(BKPSRAM_BASE + GRIPPER_HOME_BKP_OFFSET);
+static bool s_bkp_ready = false;
+
+/* ==================== 私有函数 ==================== */
+
+static void bkp_enable(void)
+{
+    if (s_bkp_ready) {
+        return;
+    }
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    __HAL_RCC_BKPSRAM_CLK_ENABLE();
+    HAL_PWREx_EnableBkUpReg();      // 备份调压器, VBAT供电时保持内容
+    s_bkp_ready = true;
+}
+
+static void rec_write(uint8_t homed, HomeRecState_t state, float height_mm)
+{
+    bkp_enable();
+    s_rec->magic = HOME_REC_MAGIC;
+    s_rec->version = HOME_REC_VERSION;
+    s_rec->homed = homed;
+    s_rec->state = (uint8_t)state;
+    s_rec->height_mm = height_mm;
+    s_rec->crc = Crc16_Calc((const uint8_t *)s_rec, (uint16_t)offsetof(HomeRecord_t, crc));
+}
+
+static bool rec_valid(void)
+{
+    return s_rec->magic == HOME_REC_MAGIC && s_rec->version == HOME_REC_VERSION &&
+           s_rec->crc == Crc16_Calc((const uint8_t *)s_rec, (uint16_t)offsetof(HomeRecord_t, crc));
+}
+
+/**
+ * @brief 触发回零并等待结束
+ * @return true=回零成功
+ * @note 回零标志清除只说明驱动器空闲, 必须看到过回零进行中, 或位置确实改变,
+ *       才算回零已执行; 否则(命令丢失/被拒绝)超过GRIPPER_HOME_START_MS判为失败
+ */
+static bool run_homing(void)
+{
+    uint32_t tickstart, t;
+    EmmRxSlot_t slot;
+    int32_t cpos0 = 0;
+    bool have_cpos0, active = false;
+
+    have_cpos0 = Emm_Read_Param(GRIPPER_LIFT_MOTOR_ADDR, S_CPOS, GRIPPER_HOME_READ_TIMEOUT_MS, &slot);
+    if (have_cpos0) {
+        cpos0 = slot.cpos;
+    }
+
+    // 回零参数每次下发(不存储), 模式与方向不依赖驱动器上的设置
+    Emm_V5_Origin_Modify_Params(GRIPPER_LIFT_MOTOR_ADDR, false, GRIPPER_HOME_MODE, GRIPPER_HOME_DIR,
+                                GRIPPER_HOME_VEL_RPM, GRIPPER_HOME_TIMEOUT_MS, GRIPPER_HOME_SL_RPM,
+                                GRIPPER_HOME_SL_MA, GRIPPER_HOME_SL_MS, false);
+    Emm_V5_Origin_Trigger_Return(GRIPPER_LIFT_MOTOR_ADDR, GRIPPER_HOME_MODE, false);
+    tickstart = HAL_GetTick();
+    while (HAL_GetTick() - tickstart < GRIPPER_HOME_TIMEOUT_MS) {
+        // 触发后立即查询一次, 以免短距离回零在第一个查询周期内结束而看不到进行中
+        if (Emm_Read_Param(GRIPPER_LIFT_MOTOR_ADDR, S_ORG, GRIPPER_HOME_READ_TIMEOUT_MS, &slot)) {
+            if (slot.org & EMM_ORG_HOME_FAILED) {
+                return false;
+            }
+            if (slot.org & EMM_ORG_HOMING) {
+                active = true;
+            } else if (active) {
+                return true;
+            } else if (have_cpos0 &&
+                       Emm_Read_Param(GRIPPER_LIFT_MOTOR_ADDR, S_CPOS, GRIPPER_HOME_READ_TIMEOUT_MS, &slot) &&
+                       fabsf(Gripper_Lift_Counts_To_Height(slot.cpos - cpos0)) > GRIPPER_HOME_TOL_MM) {
+                return true;
+            } else if (HAL_GetTick() - tickstart > GRIPPER_HOME_START_MS) {
+                break;
+            }
+        }
+        t = HAL_GetTick();
+        while (HAL_GetTick() - t < GRIPPER_HOME_POLL_MS) {
+            Motor_Background_Process();
+        }
+    }
+    Emm_V5_Origin_Interrupt(GRIPPER_LIFT_MOTOR_ADDR);
+    return false;
+}
+
+/* ==================== 公开函数 ==================== */
+
+GripperHomeResult_t Gripper_Home_Init(bool force)
+{
+    EmmRxSlot_t org, pos;
+    float height;
+
+    bkp_enable();
+
+    // 热启动: 记录有效且停稳, 驱动器状态与位置都与记录一致
+    if (!force && rec_valid() && s_rec->homed && s_rec->state == HOME_REC_IDLE &&
+        Emm_Read_Param(GRIPPER_LIFT_MOTOR_ADDR, S_ORG, GRIPPER_HOME_READ_TIMEOUT_MS, &org) &&
+        Emm_Read_Param(GRIPPER_LIFT_MOTOR_ADDR, S_CPOS, GRIPPER_HOME_READ_TIMEOUT_MS, &pos) &&
+        (org.org & (EMM_ORG_HOMING | EMM_ORG_HOME_FAILED)) == 0) {
+        height = Gripper_Lift_Counts_To_Height(pos.cpos);
+        if (fabsf(height - s_rec->height_mm) <= GRIPPER_HOME_TOL_MM) {
+            Gripper_Lift_Set_Reference(height);
+            return GRIPPER_HOME_WARM;
+        }
+    }
+
+    rec_write(0, HOME_REC_MOVING, 0.0f);
+    if (!run_homing()) {
+        return GRIPPER_HOME_FAILED;
+    }
+    Gripper_Lift_Set_Reference(GRIPPER_MIN_HEIGHT);
+    rec_write(1, HOME_REC_IDLE, GRIPPER_MIN_HEIGHT);
+    return GRIPPER_HOME_COLD;
+}
+
+void Gripper_Home_Note_Moving(void)
+{
+    bkp_enable();
+    if (rec_valid() && s_rec->state != HOME_REC_MOVING) {
+        rec_write(s_rec->homed, HOME_REC_MOVING, s_rec->height_mm);
+    }
+}
+
+void Gripper_Home_Note_Stopped(float height_mm)
+{
+    bkp_enable();
+    if (rec_valid() && s_rec->homed) {
+        rec_write(1, HOME_REC_IDLE, height_mm);
+    }
+}
@@ -0,0 +1,260 @@
+/**
+  ******************************************************************************
+  * @file    gripper_lift.c
+  * @brief   机械爪升降 (丝杆步进电机, 地址6)
+  * @details 升降以绝对位置命令下发, 不阻塞调用者:
+  *          - Gripper_Lift_Async返回句柄, 可轮询或等待完成
+  *          - 堵转由emm_rx的堵转掩码判定 (S_FLAG轮询回复会置位)
+  *          - 新命令直接改写驱动器目标位置, 旧句柄视为被取代
+  *          - 运动中按GRIPPER_LIFT_POLL_HZ轮询S_CPOS/S_FLAG, 以编码器实测高度判定到位,
+  *            驱动器报告到位后的下一次读数仍超差时判为丢步
+  *          - 是否需要运动按实测高度判断; 堵转后的新命令先解除驱动器堵转保护
+  *          Gripper_Lift_Wait为同步版本: 发起后等待完成.
+  *          gripper.c中原有的Gripper_Lift/Gripper_Get_Height保留原型, 转调本文件的
+  *          Gripper_Lift_Wait/Gripper_Lift_Get_Height
+  ******************************************************************************
+  */
+
+#include "gripper.h"
+#include "motor.h"
+#include "emm_rx.h"
+#include "emm_poll.h"
+#include "Emm_V5.h"
+#include <math.h>
+
+/* ==================== 私有变量 ==================== */
+
+static float    s_target_mm = 0.0f;         // 最近一次命令高度
+static uint16_t s_seq = 0;                  // 最近一次命令的句柄
+static bool     s_no_motion = false;        // 最近一次命令无需运动
+static uint8_t  s_cmd_cpos_seq = 0;         // 发出命令时的S_CPOS更新计数
+static uint8_t  s_arrive_cpos_seq = 0;      // 首次看到到位返回时的S_CPOS更新计数
+static bool     s_arrive_seen = false;
+static float    s_meas_mm = 0.0f;           // 最近一次实测高度
+static float    s_vel_mm_s = 0.0f;          // 由相邻两次实测高度求得
+static uint32_t s_meas_tick = 0;
+static uint8_t  s_meas_seq = 0;
+static bool     s_meas_valid = false;
+static bool     s_polling = false;
+
+/* ==================== 私有函数 ==================== */
+
+static float clamp_height(float height_mm)
+{
+    if (height_mm < GRIPPER_MIN_HEIGHT) return GRIPPER_MIN_HEIGHT;
+    if (height_mm > GRIPPER_MAX_HEIGHT) return GRIPPER_MAX_HEIGHT;
+    return height_mm;
+}
+
+static void lift_poll_enable(bool on)
+{
+    if (on == s_polling) {
+        return;
+    }
+    s_polling = on;
+    Emm_Poll_Config(GRIPPER_LIFT_MOTOR_ADDR, S_CPOS, on ? GRIPPER_LIFT_POLL_HZ : 0);
+    Emm_Poll_Config(GRIPPER_LIFT_MOTOR_ADDR, S_FLAG, on ? GRIPPER_LIFT_POLL_HZ / 2U : 0);
+}
+
+/**
+ * @brief 取入新的S_CPOS读数, 更新实测高度与速度
+ * @return true=有新读数
+ */
+static bool lift_measure(void)
+{
+    uint8_t seq = Emm_Rx_Param_Seq(GRIPPER_LIFT_MOTOR_ADDR, S_CPOS);
+    EmmRxSlot_t slot;
+    float h;
+
+    if (seq == s_meas_seq || !Emm_Rx_Get(GRIPPER_LIFT_MOTOR_ADDR, &slot)) {
+        return false;
+    }
+    h = Gripper_Lift_Counts_To_Height(slot.cpos);
+    if (s_meas_valid && slot.param_tick[S_CPOS] != s_meas_tick) {
+        s_vel_mm_s = (h - s_meas_mm) * 1000.0f / (float)(slot.param_tick[S_CPOS] - s_meas_tick);
+    }
+    s_meas_mm = h;
+    s_meas_tick = slot.param_tick[S_CPOS];
+    s_meas_seq = seq;
+    s_meas_valid = true;
+    return true;
+}
+
+/* ==================== 公开函数 ==================== */
+
+GripperLiftHandle_t Gripper_Lift_Async(float height_mm)
+{
+    int32_t clk;
+    bool stalled = false;
+    float from_mm;
+
+    height_mm = clamp_height(height_mm);
+    if (++s_seq == GRIPPER_LIFT_HANDLE_NONE) {
+        s_seq++;
+    }
+
+    // 上次命令堵转: 解除驱动器堵转保护并清除堵转位, 否则新命令会被拒绝或立即判为堵转
+    if (Emm_Rx_Stall_Mask() & GRIPPER_LIFT_MASK) {
+        Emm_V5_Reset_Clog_Pro(GRIPPER_LIFT_MOTOR_ADDR);
+        Emm_Rx_Clear_Stall(GRIPPER_LIFT_MASK);
+        stalled = true;
+    }
+
+    // 静止时按实测高度判断是否需要运动; 运动中(轮询未关闭)一律改写目标
+    lift_measure();
+    from_mm = s_meas_valid ? s_meas_mm : s_target_mm;
+    s_no_motion = !stalled && !s_polling && fabsf(height_mm - from_mm) <= GRIPPER_LIFT_TOL_MM;
+    s_target_mm = height_mm;
+    if (s_no_motion) {
+        return s_seq;
+    }
+
+    // 绝对位置: 零点为回零位置, 正高度对应GRIPPER_LIFT_DIR_UP方向
+    clk = (int32_t)lroundf(height_mm * GRIPPER_CLK_PER_MM);
+    lift_poll_enable(true);
+    Gripper_Home_Note_Moving();
+    s_cmd_cpos_seq = Emm_Rx_Param_Seq(GRIPPER_LIFT_MOTOR_ADDR, S_CPOS);
+    s_arrive_seen = false;
+    Motor_Arm_Arrival(GRIPPER_LIFT_MASK);
+    Emm_V5_Pos_Control(GRIPPER_LIFT_MOTOR_ADDR, GRIPPER_LIFT_DIR_UP, GRIPPER_DEFAULT_SPEED,
+                       GRIPPER_DEFAULT_ACC, (uint32_t)clk, true, false);
+    return s_seq;
+}
+
+GripperLiftState_t Gripper_Lift_Poll(GripperLiftHandle_t h)
+{
+    bool fresh, in_tol;
+
+    if (h == GRIPPER_LIFT_HANDLE_NONE) {
+        return GRIPPER_LIFT_DONE;
+    }
+    if (h != s_seq) {
+        return GRIPPER_LIFT_SUPERSEDED;
+    }
+    if (s_no_motion) {
+        return GRIPPER_LIFT_DONE;
+    }
+    if (Emm_Rx_Stall_Mask() & GRIPPER_LIFT_MASK) {
+        lift_poll_enable(false);
+        return GRIPPER_LIFT_STALLED;
+    }
+
+    lift_measure();
+    fresh = s_meas_valid && s_meas_seq != s_cmd_cpos_seq;   // 命令之后的读数
+    in_tol = fresh && fabsf(s_meas_mm - s_target_mm) <= GRIPPER_LIFT_TOL_MM;
+
+    // 实测高度进入容差即完成, 不必等驱动器减速到零
+    if (in_tol) {
+        lift_poll_enable(false);
+        Gripper_Home_Note_Stopped(s_target_mm);
+        return GRIPPER_LIFT_DONE;
+    }
+    if (Emm_Rx_Arrived_Mask() & GRIPPER_LIFT_MASK) {
+        // 驱动器已到位: 只用到位之后才收到的读数确认, 之前的读数可能仍在途中
+        if (!s_arrive_seen) {
+            s_arrive_seen = true;
+            s_arrive_cpos_seq = Emm_Rx_Param_Seq(GRIPPER_LIFT_MOTOR_ADDR, S_CPOS);
+        }
+        if (!fresh || s_meas_seq == s_arrive_cpos_seq) {
+            return GRIPPER_LIFT_BUSY;
+        }
+        lift_poll_enable(false);
+        return GRIPPER_LIFT_MISSED;
+    }
+    return GRIPPER_LIFT_BUSY;
+}
+
+GripperLiftState_t Gripper_Lift_Join(GripperLiftHandle_t h, uint32_t timeout_ms)
+{
+    uint32_t tickstart = HAL_GetTick();
+    GripperLiftState_t st;
+
+    while ((st = Gripper_Lift_Poll(h)) == GRIPPER_LIFT_BUSY) {
+        Motor_Background_Process();
+        if (HAL_GetTick() - tickstart > timeout_ms) {
+            break;
+        }
+    }
+    return st;
+}
+
+void Gripper_Lift_Abort(GripperLiftHandle_t h)
+{
+    if (Gripper_Lift_Poll(h) != GRIPPER_LIFT_BUSY) {
+        return;
+    }
+    Emm_V5_Stop_Now(GRIPPER_LIFT_MOTOR_ADDR, false);
+    lift_poll_enable(false);
+    lift_measure();
+    if (s_meas_valid) {
+        s_target_mm = s_meas_mm;
+    }
+    Gripper_Home_Note_Stopped(s_target_mm);
+    if (++s_seq == GRIPPER_LIFT_HANDLE_NONE) {
+        s_seq++;
+    }
+    s_no_motion = true;
+}
+
+GripperLiftState_t Gripper_Lift_Wait(float height_mm)
+{
+    GripperLiftHandle_t h = Gripper_Lift_Async(height_mm);
+    GripperLiftState_t st = Gripper_Lift_Join(h, GRIPPER_LIFT_TIMEOUT_MS);
+
+    if (st == GRIPPER_LIFT_BUSY) {
+        Gripper_Lift_Abort(h);
+    }
+    return st;
+}
+
+float Gripper_Lift_Get_Height(void)
+{
+    lift_measure();
+    return s_meas_valid ? s_meas_mm : s_target_mm;
+}
+
+float Gripper_Lift_Counts_To_Height(int32_t cpos)
+{
+    float pulses = (float)cpos * (float)GRIPPER_LIFT_PULSES_PER_REV / (float)EMM_COUNTS_PER_REV;
+
+    return ((GRIPPER_LIFT_DIR_UP == 0) ? pulses : -pulses) / (float)GRIPPER_CLK_PER_MM;
+}
+
+void Gripper_Lift_Set_Reference(float height_mm)
+{
+    s_target_mm = height_mm;
+    s_no_motion = true;
+    s_meas_valid = false;
+    s_meas_seq = Emm_Rx_Param_Seq(GRIPPER_LIFT_MOTOR_ADDR, S_CPOS);
+}
+
+float Gripper_Get_Target_Height(void)
+{
+    return s_target_mm;
+}
+
+bool Gripper_Lift_Get_Status(GripperLiftStatus_t *out)
+{
+    EmmRxSlot_t slot;
+
+    lift_measure();
+    Emm_Rx_Get(GRIPPER_LIFT_MOTOR_ADDR, &slot);
+    out->height_mm = s_meas_mm;
+    out->vel_mm_s = s_vel_mm_s;
+    out->target_mm = s_target_mm;
+    out->age_ms = HAL_GetTick() - s_meas_tick;
+    out->flags = slot.flags;
+    out->stalled = (Emm_Rx_Stall_Mask() & GRIPPER_LIFT_MASK) != 0;
+    return s_meas_valid;
+}
+
+bool Gripper_Lift_Refresh(uint32_t timeout_ms)
+{
+    EmmRxSlot_t slot;
+
+    if (!Emm_Read_Param(GRIPPER_LIFT_MOTOR_ADDR, S_CPOS, timeout_ms, &slot)) {
+        return false;
+    }
+    lift_measure();
+    return true;
+}
@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file    gripper_seq.c
+  * @brief   机械爪动作序列引擎
+  * @details 抓取/放置流程以步骤表描述, 每步给出执行机构、目标值与依赖:
+  *          - 依赖步骤全部完成即启动, 互不依赖的步骤(如升降与云台)并行执行
+  *          - 升降以Gripper_Lift_Async句柄判定完成, 舵机按转速模型预测的到位时间判定
+  *          - 记录每步的启动与完成时刻, 便于按实测数据调整序列
+  ******************************************************************************
+  */
+
+#include "gripper.h"
+#include "motor.h"
+#include "servo.h"
+#include <string.h>
+
+/* ==================== 私有变量 ==================== */
+
+static GripperStepLog_t s_log[GRIPPER_SEQ_MAX_STEPS];
+static uint8_t          s_log_count = 0;
+
+/* ==================== 私有函数 ==================== */
+
+/**
+ * @brief 启动一步, 返回该步的到位时间 (升降返回0, 由句柄判定)
+ * @note 舵机未指定settle_ms时使用斜坡运动的预测到位时间
+ */
+static uint16_t step_start(const GripperStep_t *st, GripperLiftHandle_t *lift)
+{
+    uint32_t t = 0;
+
+    switch (st->act) {
+        case GRIP_ACT_LIFT:
+            *lift = Gripper_Lift_Async(st->value);
+            return 0;
+        case GRIP_ACT_PAN:
+            t = Servo_Move(SERVO_PAN, st->value, 0.0f);
+            break;
+        case GRIP_ACT_CLAW_OPEN:
+            t = Servo_Move(SERVO_CLAW, GRIPPER_CLAW_MAX_ANGLE, 0.0f);
+            break;
+        case GRIP_ACT_CLAW_CLOSE:
+            t = Servo_Move(SERVO_CLAW, GRIPPER_CLAW_MIN_ANGLE, 0.0f);
+            break;
+        case GRIP_ACT_WAIT:
+        default:
+            break;
+    }
+    return st->settle_ms ? st->settle_ms : (uint16_t)t;
+}
+
+/* ==================== 公开函数 ==================== */
+
+uint8_t Gripper_Seq_Run(const GripperStep_t *steps, uint8_t count)
+{
+    GripperLiftHandle_t lift[GRIPPER_SEQ_MAX_STEPS];
+    uint16_t settle[GRIPPER_SEQ_MAX_STEPS];
+    uint32_t started = 0, done = 0;
+    uint32_t all = (count >= 32U) ? 0xFFFFFFFFUL : ((1UL << count) - 1U);
+    uint32_t t0 = HAL_GetTick();
+    uint8_t i;
+
+    s_log_count = 0;
+    memset(s_log, 0, sizeof(s_log));
+    if (count == 0 || count > GRIPPER_SEQ_MAX_STEPS) {
+        return 1;
+    }
+    for (i = 0; i < count; i++) {
+        if (steps[i].after & ~all) {
+            return 1;       // 依赖了不存在的步骤
+        }
+    }
+
+    while (done != all) {
+        uint32_t now;
+
+        // 启动依赖已满足的步骤
+        for (i = 0; i < count; i++) {
+            if (!(started & (1UL << i)) && (steps[i].after & done) == steps[i].after) {
+                lift[i] = GRIPPER_LIFT_HANDLE_NONE;
+                settle[i] = step_start(&steps[i], &lift[i]);
+                started |= 1UL << i;
+                s_log[i].start_ms = (uint16_t)(HAL_GetTick() - t0);
+            }
+        }
+
+        if ((started & ~done) == 0) {
+            // 没有运行中的步骤且剩余步骤无法启动: 依赖成环
+            s_log_count = count;
+            return 1;
+        }
+
+        Motor_Background_Process();
+        now = HAL_GetTick();
+
+        // 检查完成
+        for (i = 0; i < count; i++) {
+            uint32_t bit = 1UL << i;
+            bool finished;
+
+            if (!(started & bit) || (done & bit)) {
+                continue;
+            }
+            if (steps[i].act == GRIP_ACT_LIFT) {
+                GripperLiftState_t ls = Gripper_Lift_Poll(lift[i]);
+                if (ls == GRIPPER_LIFT_STALLED || ls == GRIPPER_LIFT_MISSED || ls == GRIPPER_LIFT_SUPERSEDED) {
+                    // 升降未到达目标高度, 不能继续松爪/放置
+                    s_log_count = count;
+                    return (ls == GRIPPER_LIFT_STALLED) ? 2 : (ls == GRIPPER_LIFT_MISSED) ? 4 : 5;
+                }
+                finished = (ls == GRIPPER_LIFT_DONE);
+            } else {
+                finished = (now - t0 - s_log[i].start_ms >= settle[i]);
+            }
+            if (finished) {
+                done |= bit;
+                s_log[i].end_ms = (uint16_t)(now - t0);
+            }
+        }
+
+        if (now - t0 > GRIPPER_SEQ_TIMEOUT_MS) {
+            for (i = 0; i < count; i++) {
+                if ((started & ~done & (1UL << i)) && steps[i].act == GRIP_ACT_LIFT) {
+                    Gripper_Lift_Abort(lift[i]);
+                }
+            }
+            s_log_count = count;
+            return 3;
+        }
+    }
+    s_log_count = count;
+    return 0;
+}
+
+uint8_t Gripper_Seq_Get_Log(const GripperStepLog_t **log)
+{
+    *log = s_log;
+    return s_log_count;
+}
+
+uint8_t Gripper_Seq_PickAndPlace(int plate_number, bool return_home)
+{
+    float pan;
+    GripperStep_t seq[] = {
+        /* 0 */ { GRIP_ACT_CLAW_CLOSE, 0.0f,                0, 0 },
+        /* 1 */ { GRIP_ACT_LIFT,       HEIGHT_TRANSPORT,    0, GRIP_AFTER(0) },
+        /* 2 */ { GRIP_ACT_PAN,        PAN_ANGLE_PLATE1,    0, GRIP_AFTER(0) },
+        /* 3 */ { GRIP_ACT_CLAW_OPEN,  0.0f,                0, GRIP_AFTER(1) | GRIP_AFTER(2) },
+        /* 4 */ { GRIP_ACT_PAN,        PAN_ANGLE_GRAB,      0, GRIP_AFTER(3) },
+        /* 5 */ { GRIP_ACT_LIFT,       HEIGHT_PICKUP_LOWER, 0, GRIP_AFTER(3) },
+    };
+
+    switch (plate_number) {
+        case 1: pan = PAN_ANGLE_PLATE1; break;
+        case 2: pan = PAN_ANGLE_PLATE2; break;
+        case 3: pan = PAN_ANGLE_PLATE3; break;
+        default: return 1;
+    }
+    seq[2].value = pan;
+    return Gripper_Seq_Run(seq, return_home ? 6 : 4);
+}
@@ -0,0 +1,81 @@
+/**
+  ******************************************************************************
+  * @file    hal_callbacks.c
+  * @brief   HAL弱回调与新增中断入口的统一定义处
+  * @details HAL的回调(HAL_xxx_Callback)是全局弱符号, 只能有一个强定义.
+  *          各模块只提供普通处理函数, 由本文件按外设实例分发:
+  *          - TIM1更新: 舵机斜坡 Servo_Ramp_Update
+  *          - 串口发送完成: 电机总线发送队列 Emm_Bus_TxCpltCallback
+  *          - 串口接收事件/错误: 电机回复解析 emm_rx, 视觉推流 visual_stream
+  *          - 串口接收完成(中断方式): visual_comm旧请求-应答接收, 仅在推流交出USART3后发生
+  *          各处理函数自行判断串口实例, 不属于自己的直接返回.
+  *          main.c/usart.c等其他文件不再定义这些回调; 需要新的分支时在此添加.
+  *          HAL时基为SysTick(见stm32f4xx_it.h), 不需要在定时器回调中调用HAL_IncTick
+  ******************************************************************************
+  */
+
+#include "main.h"
+#include "tim.h"
+#include "usart.h"
+#include "servo.h"
+#include "emm_bus.h"
+#include "emm_rx.h"
+#include "visual_stream.h"
+#include "stm32f4xx_it.h"
+
+/* ==================== 中断入口 ==================== */
+
+/**
+ * @brief TIM1更新中断 (与TIM10共用向量)
+ * @note CubeMX未开启该中断, 故不在stm32f4xx_it.c中生成; 若以后在CubeMX中开启,
+ *       删除此处定义以免重复
+ */
+void TIM1_UP_TIM10_IRQHandler(void)
+{
+    HAL_TIM_IRQHandler(&htim1);
+}
+
+/* ==================== HAL回调 ==================== */
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM1) {
+        Servo_Ramp_Update();
+    }
+}
+
+/**
+ * @brief 串口DMA发送完成 (DMA2_Stream7_IRQHandler等 -> HAL_DMA_IRQHandler -> 此处)
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    Emm_Bus_TxCpltCallback(huart);
+}
+
+/**
+ * @brief 串口接收事件 (RX DMA半满/全满, 或USARTx_IRQHandler中的IDLE)
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    Emm_Rx_EventCallback(huart, Size);
+    Visual_Stream_EventCallback(huart, Size);
+}
+
+/**
+ * @brief 串口中断接收完成, 只有visual_comm旧接口使用
+ */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == &huart3 && !Visual_Stream_Rx_Owned()) {
+        Visual_UART_RxCallback();
+    }
+}
+
+/**
+ * @brief 串口错误 (溢出/噪声/帧错误会停止DMA, 各模块重新启动自己的接收)
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    Emm_Rx_ErrorCallback(huart);
+    Visual_Stream_ErrorCallback(huart);
+}
@@ -0,0 +1,681 @@
+/**
+  ******************************************************************************
+  * @file    emm_sim.c
+  * @brief   Emm_V5步进闭环驱动器总线模拟器实现
+  ******************************************************************************
+  */
+
+#include "emm_sim.h"
+#include "gripper.h"
+#include <math.h>
+
+/* ==================== 私有类型 ==================== */
+
+typedef enum {
+    SIM_MODE_IDLE = 0,
+    SIM_MODE_POS,
+    SIM_MODE_VEL
+} SimMode_t;
+
+typedef struct {
+    UART_HandleTypeDef *huart;      // 驱动器所在总线
+    bool     present;
+    bool     is_wheel;
+    bool     enabled;
+    bool     stalled;
+    uint8_t  org_flags;             // bit2=正在回零 bit3=回零失败
+    uint64_t home_end_us;           // 回零最早结束时刻 (碰撞检测/退让耗时)
+
+    double   pos;                   // 实际位置 (脉冲)
+    double   vel;                   // 实际转速 (RPM, 带符号)
+    double   target;                // 目标位置 (脉冲)
+    double   cmd_vel;               // 指令转速 (位置模式为幅值, 速度模式带符号)
+    uint8_t  acc;
+    SimMode_t mode;
+
+    /* snF=1时暂存, 等待同步触发 */
+    bool     staged;
+    SimMode_t st_mode;
+    double   st_target;
+    double   st_vel;
+    uint8_t  st_acc;
+
+    uint64_t cmd_t_start;           // 本次运动对应命令开始发送的时间
+    bool     latency_open;
+    uint64_t tx_free_us;            // 本驱动器上一帧回复发完的时刻, 自身回复串行发出
+
+    EmmSimDriverStats_t stats;
+} SimDriver_t;
+
+typedef struct {
+    uint64_t t_apply;
+    uint64_t t_cmd_start;
+    uint8_t  len;
+    uint8_t  data[24];
+} SimEvent_t;
+
+/**
+ * @brief 单路总线: 各自的命令事件队列, 总线之间互不阻塞
+ */
+typedef struct {
+    UART_HandleTypeDef *huart;
+    SimEvent_t evt[EMM_SIM_EVENT_QUEUE];
+    uint16_t   head;
+    uint16_t   tail;
+    uint64_t   rx_end_us;           // RX线上最晚结束的一帧回复的结束时刻
+    uint8_t    rx_addr;             // 该帧的发送者
+} SimBusIf_t;
+
+/* ==================== 私有变量 ==================== */
+
+static const uint8_t s_default_addrs[] = { 1, 2, 3, 4, GRIPPER_LIFT_MOTOR_ADDR };
+
+static SimBusIf_t   s_if[EMM_SIM_MAX_BUSES];
+static uint8_t      s_if_count = 0;
+static SimDriver_t  s_drv[256];
+static uint8_t      s_addr_list[EMM_SIM_MAX_DRIVERS];
+static uint8_t      s_addr_count = 0;
+static uint64_t     s_last_tick_us = 0;
+static EmmSimBusStats_t s_bus;
+
+/* 车轮启动批次, 用于计算同步偏差 */
+static bool     s_group_open = false;
+static uint8_t  s_group_n = 0;
+static uint64_t s_group_first_us = 0;
+static uint64_t s_group_last_us = 0;
+
+#define SIM_GROUP_WINDOW_US     20000U
+#define SIM_K_PULSE_PER_US      ((double)EMM_SIM_PULSES_PER_REV / 60.0e6)   // 每RPM对应的脉冲/us
+
+/* ==================== 私有函数 ==================== */
+
+static uint8_t frame_len(uint8_t func)
+{
+    switch (func) {
+        case 0xFD: return 13;   // 位置模式
+        case 0xF6: return 8;    // 速度模式
+        case 0xFE: return 5;    // 立即停止
+        case 0xFF: return 4;    // 多机同步
+        case 0xF3: return 6;    // 使能控制
+        case 0x0A: return 4;    // 位置清零
+        case 0x0E: return 4;    // 解除堵转保护
+        case 0x9A: return 5;    // 触发回零
+        case 0x9C: return 4;    // 中断回零
+        case 0x93: return 5;    // 设置零点
+        case 0x4C: return 20;   // 修改回零参数
+        case 0x46: return 6;    // 修改控制模式
+        case 0x42:
+        case 0x43: return 4;    // 读取驱动/系统参数
+        case 0x1F: case 0x20: case 0x21: case 0x24: case 0x27: case 0x31:
+        case 0x33: case 0x35: case 0x36: case 0x37: case 0x3A: case 0x3B:
+            return 3;           // 读取参数
+        default:   return 0;
+    }
+}
+
+static SimBusIf_t *find_bus(const UART_HandleTypeDef *huart)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_if_count; i++) {
+        if (s_if[i].huart == huart) {
+            return &s_if[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 驱动器发送回复
+ * @note 同一路总线的驱动器共用RX线且互不侦听: 回复起始时刻落在另一驱动器的回复之内时,
+ *       两帧从重叠处起全部损坏 (以0xFF代替, 解析器按帧尾错误丢弃)
+ */
+static void reply(uint8_t addr, const uint8_t *data, uint8_t len, uint64_t now)
+{
+    SimDriver_t *d = &s_drv[addr];
+    SimBusIf_t *bus;
+    uint8_t buf[16];
+    uint64_t start, end;
+
+    if (addr == 0 || len + 1U > sizeof(buf)) {
+        return;     // 广播命令不回复
+    }
+    buf[0] = addr;
+    memcpy(&buf[1], data, len);
+
+    start = now + EMM_SIM_REPLY_LATENCY_US;
+    if (start < d->tx_free_us) {
+        start = d->tx_free_us;
+    }
+    end = start + Host_UART_Wire_Time_us(d->huart, (uint16_t)(len + 1U));
+    d->tx_free_us = end;
+
+    bus = find_bus(d->huart);
+    if (bus != NULL) {
+        if (bus->rx_addr != addr && start < bus->rx_end_us) {
+            s_bus.reply_collisions++;
+            Host_UART_Garble_Rx(d->huart, start);
+            memset(buf, 0xFF, (size_t)(len + 1U));
+        }
+        if (end > bus->rx_end_us) {
+            bus->rx_end_us = end;
+            bus->rx_addr = addr;
+        }
+    }
+    Host_UART_Feed_Rx(d->huart, buf, (uint16_t)(len + 1U), start);
+    s_bus.replies_tx++;
+}
+
+static void reply_ack(uint8_t addr, uint8_t func, uint8_t status, uint64_t now)
+{
+    uint8_t d[3] = { func, status, 0x6B };
+    reply(addr, d, 3, now);
+}
+
+static void put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static uint32_t counts_from_pulses(double pulses)
+{
+    return (uint32_t)llround(fabs(pulses) * EMM_SIM_COUNTS_PER_REV / EMM_SIM_PULSES_PER_REV);
+}
+
+static void group_close(void)
+{
+    if (s_group_open && s_group_n >= 2) {
+        uint32_t skew = (uint32_t)(s_group_last_us - s_group_first_us);
+        s_bus.start_groups++;
+        s_bus.start_skew_sum_us += skew;
+        if (skew > s_bus.start_skew_max_us) s_bus.start_skew_max_us = skew;
+    }
+    s_group_open = false;
+    s_group_n = 0;
+}
+
+static void motion_started(SimDriver_t *d, uint64_t now)
+{
+    d->stats.move_count++;
+    if (d->latency_open) {
+        uint32_t lat = (uint32_t)(now - d->cmd_t_start);
+        d->stats.latency_sum_us += lat;
+        if (lat > d->stats.latency_max_us) d->stats.latency_max_us = lat;
+        d->latency_open = false;
+    }
+
+    if (!d->is_wheel) {
+        return;
+    }
+    if (s_group_open && now - s_group_first_us > SIM_GROUP_WINDOW_US) {
+        group_close();
+    }
+    if (!s_group_open) {
+        s_group_open = true;
+        s_group_first_us = now;
+    }
+    s_group_last_us = now;
+    s_group_n++;
+}
+
+static void start_motion(SimDriver_t *d, SimMode_t mode, double target, double vel,
+                         uint8_t acc, uint64_t now)
+{
+    d->mode = mode;
+    d->acc = acc;
+    if (mode == SIM_MODE_POS) {
+        d->target = target;
+        d->cmd_vel = fabs(vel);
+    } else {
+        d->cmd_vel = vel;
+    }
+    motion_started(d, now);
+}
+
+static void apply_sync(const SimBusIf_t *bus, uint8_t addr, uint64_t now)
+{
+    uint8_t i;
+
+    s_bus.sync_triggers++;
+    for (i = 0; i < s_addr_count; i++) {
+        SimDriver_t *d = &s_drv[s_addr_list[i]];
+        if (d->huart == bus->huart && (addr == 0 || addr == s_addr_list[i]) && d->staged) {
+            d->staged = false;
+            start_motion(d, d->st_mode, d->st_target, d->st_vel, d->st_acc, now);
+        }
+    }
+}
+
+static void handle_read(SimDriver_t *d, uint8_t addr, uint8_t func, uint64_t now)
+{
+    uint8_t r[8];
+    uint32_t v;
+
+    r[0] = func;
+    switch (func) {
+        case 0x36:  // S_CPOS
+        case 0x33:  // S_TPOS
+        case 0x37:  // S_PERR
+        {
+            // S_TPOS为命令的最终目标; S_PERR与实物一致为实时设定位置与实际位置之差(跟随误差),
+            // 运动中只有转速对应的滞后量, 不是到最终目标的剩余行程
+            double val = (func == 0x36) ? d->pos :
+                         (func == 0x33) ? d->target :
+                         d->vel * SIM_K_PULSE_PER_US * EMM_SIM_FOLLOW_LAG_US;
+            r[1] = (val < 0) ? 0x01 : 0x00;
+            put_be32(&r[2], counts_from_pulses(val));
+            r[6] = 0x6B;
+            reply(addr, r, 7, now);
+            break;
+        }
+        case 0x35:  // S_VEL
+            v = (uint32_t)lround(fabs(d->vel));
+            r[1] = (d->vel < 0) ? 0x01 : 0x00;
+            r[2] = (uint8_t)(v >> 8);
+            r[3] = (uint8_t)v;
+            r[4] = 0x6B;
+            reply(addr, r, 5, now);
+            break;
+        case 0x24:  // S_VBUS
+            r[1] = (uint8_t)(EMM_SIM_VBUS_MV >> 8);
+            r[2] = (uint8_t)EMM_SIM_VBUS_MV;
+            r[3] = 0x6B;
+            reply(addr, r, 4, now);
+            break;
+        case 0x3A:  // S_FLAG
+            r[1] = (uint8_t)((d->enabled ? 0x01 : 0x00) |
+                             ((d->mode == SIM_MODE_IDLE && !d->staged) ? 0x02 : 0x00) |
+                             (d->stalled ? 0x0C : 0x00));
+            r[2] = 0x6B;
+            reply(addr, r, 3, now);
+            break;
+        case 0x3B:  // S_ORG
+            if (d->mode == SIM_MODE_IDLE && now >= d->home_end_us) {
+                d->org_flags &= (uint8_t)~0x04;
+            }
+            r[1] = (uint8_t)(0x03 | d->org_flags);  // 编码器就绪 + 校准表就绪
+            r[2] = 0x6B;
+            reply(addr, r, 3, now);
+            break;
+        case 0x1F:  // S_VER
+            r[1] = 0x7D;
+            r[2] = 0x78;
+            r[3] = 0x6B;
+            reply(addr, r, 4, now);
+            break;
+        default:
+            reply_ack(addr, func, 0xEE, now);
+            break;
+    }
+}
+
+static void handle_frame(const SimBusIf_t *bus, const SimEvent_t *e, uint64_t now)
+{
+    const uint8_t *p = e->data;
+    uint8_t addr = p[0];
+    uint8_t func = p[1];
+    uint8_t i;
+
+    s_bus.frames_rx++;
+
+    if (func == 0xFF) {
+        if (p[2] == 0x66) apply_sync(bus, addr, now);
+        return;
+    }
+
+    for (i = 0; i < s_addr_count; i++) {
+        uint8_t a = s_addr_list[i];
+        SimDriver_t *d = &s_drv[a];
+
+        if (d->huart != bus->huart || (addr != 0 && addr != a)) {
+            continue;
+        }
+        d->stats.cmd_count++;
+
+        switch (func) {
+            case 0xFD:  // 位置模式
+            case 0xF6:  // 速度模式
+            {
+                uint8_t dir = p[2];
+                double vel = (double)((uint16_t)(p[3] << 8) | p[4]);
+                uint8_t acc = p[5];
+                bool snF;
+                SimMode_t mode;
+                double target = d->target;
+
+                if (func == 0xFD) {
+                    uint32_t clk = ((uint32_t)p[6] << 24) | ((uint32_t)p[7] << 16) |
+                                   ((uint32_t)p[8] << 8) | p[9];
+                    double delta = dir ? -(double)clk : (double)clk;
+                    target = p[10] ? delta : (d->target + delta);
+                    snF = p[11] != 0;
+                    mode = SIM_MODE_POS;
+                } else {
+                    vel = dir ? -vel : vel;
+                    snF = p[6] != 0;
+                    mode = SIM_MODE_VEL;
+                }
+
+                if (!d->enabled || d->stalled) {
+                    reply_ack(addr, func, 0xE2, now);
+                    break;
+                }
+                if (!d->latency_open) {
+                    d->cmd_t_start = e->t_cmd_start;
+                    d->latency_open = true;
+                }
+                if (snF) {
+                    d->staged = true;
+                    d->st_mode = mode;
+                    d->st_target = target;
+                    d->st_vel = vel;
+                    d->st_acc = acc;
+                } else {
+                    start_motion(d, mode, target, vel, acc, now);
+                }
+                reply_ack(addr, func, 0x02, now);
+                break;
+            }
+            case 0xFE:  // 立即停止
+                d->mode = SIM_MODE_IDLE;
+                d->vel = 0.0;
+                d->target = d->pos;
+                d->staged = false;
+                reply_ack(addr, func, 0x02, now);
+                break;
+            case 0xF3:  // 使能
+                d->enabled = p[3] != 0;
+                if (!d->enabled) {
+                    d->mode = SIM_MODE_IDLE;
+                    d->vel = 0.0;
+                }
+                reply_ack(addr, func, 0x02, now);
+                break;
+            case 0x0A:  // 当前位置清零
+                d->pos = 0.0;
+                d->target = 0.0;
+                reply_ack(addr, func, 0x02, now);
+                break;
+            case 0x0E:  // 解除堵转保护
+                d->stalled = false;
+                reply_ack(addr, func, 0x02, now);
+                break;
+            case 0x9A:  // 触发回零: 以60RPM回到零点
+                d->org_flags = 0x04;
+                d->home_end_us = now + EMM_SIM_HOME_MIN_US;
+                d->cmd_t_start = e->t_cmd_start;
+                d->latency_open = true;
+                start_motion(d, SIM_MODE_POS, 0.0, 60.0, 0, now);
+                reply_ack(addr, func, 0x02, now);
+                break;
+            case 0x9C:  // 中断回零
+                d->org_flags = 0x00;
+                d->mode = SIM_MODE_IDLE;
+                d->vel = 0.0;
+                reply_ack(addr, func, 0x02, now);
+                break;
+            case 0x1F: case 0x20: case 0x21: case 0x24: case 0x27: case 0x31:
+            case 0x33: case 0x35: case 0x36: case 0x37: case 0x3A: case 0x3B:
+                if (addr != 0) handle_read(d, a, func, now);
+                break;
+            default:
+                reply_ack(addr, func, 0x02, now);
+                break;
+        }
+    }
+}
+
+static void integrate(SimDriver_t *d, uint8_t addr, double dt, uint64_t now)
+{
+    double rate = d->acc ? dt / ((256.0 - d->acc) * 50.0) : 1e9;   // 本步最大速度变化 (RPM)
+
+    if (d->mode == SIM_MODE_IDLE) {
+        return;
+    }
+    d->stats.busy_us += (uint64_t)dt;
+
+    if (d->stalled) {
+        d->vel = 0.0;
+        return;
+    }
+
+    if (d->mode == SIM_MODE_VEL) {
+        double dv = d->cmd_vel - d->vel;
+        d->vel += (fabs(dv) <= rate) ? dv : (dv > 0 ? rate : -rate);
+        d->pos += d->vel * SIM_K_PULSE_PER_US * dt;
+        if (d->cmd_vel == 0.0 && d->vel == 0.0) {
+            d->mode = SIM_MODE_IDLE;
+        }
+        d->target = d->pos;
+        return;
+    }
+
+    /* 位置模式: 梯形速度曲线 */
+    {
+        double remaining = d->target - d->pos;
+        double sgn = (remaining >= 0) ? 1.0 : -1.0;
+        double speed = fabs(d->vel);
+        double a = d->acc ? (1.0 / ((256.0 - d->acc) * 50.0)) : 0.0;     // RPM/us
+        double brake = a > 0 ? (speed * speed) / (2.0 * a) * SIM_K_PULSE_PER_US : 0.0;
+        double step;
+
+        if (d->vel * sgn < 0) {
+            speed = 0.0;    // 反向: 先减速到零 (简化为立即换向)
+        }
+        if (a > 0 && fabs(remaining) <= brake + speed * SIM_K_PULSE_PER_US * dt) {
+            speed -= rate;
+            if (speed < 1.0) speed = 1.0;
+        } else {
+            speed += rate;
+            if (speed > d->cmd_vel) speed = d->cmd_vel;
+        }
+
+        step = speed * SIM_K_PULSE_PER_US * dt;
+        if (step >= fabs(remaining) || fabs(remaining) < 0.5) {
+            uint8_t arrive[3] = { 0xFD, 0x9F, 0x6B };
+            d->pos = d->target;
+            d->vel = 0.0;
+            d->mode = SIM_MODE_IDLE;
+            if (now >= d->home_end_us) {
+                d->org_flags &= (uint8_t)~0x04;
+            }
+            d->stats.arrive_count++;
+            reply(addr, arrive, 3, now);
+            return;
+        }
+        d->pos += sgn * step;
+        d->vel = sgn * speed;
+    }
+}
+
+static void sim_tick(uint64_t now)
+{
+    double dt;
+    uint8_t i;
+
+    // 处理已到达驱动器的命令
+    for (i = 0; i < s_if_count; i++) {
+        SimBusIf_t *bus = &s_if[i];
+        while (bus->tail != bus->head && bus->evt[bus->tail].t_apply <= now) {
+            handle_frame(bus, &bus->evt[bus->tail], now);
+            bus->tail = (uint16_t)((bus->tail + 1U) % EMM_SIM_EVENT_QUEUE);
+        }
+    }
+
+    dt = (double)(now - s_last_tick_us);
+    s_last_tick_us = now;
+    if (dt <= 0.0) {
+        return;
+    }
+    for (i = 0; i < s_addr_count; i++) {
+        integrate(&s_drv[s_addr_list[i]], s_addr_list[i], dt, now);
+    }
+}
+
+/**
+ * @brief UART发送汇聚点: 拆分(可能连续的)多帧并按字节时序排入事件队列
+ */
+static void sim_tx_sink(void *ctx, const uint8_t *data, uint16_t len,
+                        uint64_t t_start, uint64_t t_end)
+{
+    SimBusIf_t *bus = (SimBusIf_t *)ctx;
+    uint64_t bt = len ? (t_end - t_start) / len : 0;
+    uint16_t off = 0;
+
+    while (off + 2U <= len) {
+        uint8_t flen = frame_len(data[off + 1]);
+        uint16_t next = (uint16_t)((bus->head + 1U) % EMM_SIM_EVENT_QUEUE);
+
+        if (flen == 0 || off + flen > len || data[off + flen - 1] != 0x6B || flen > sizeof(bus->evt[0].data)) {
+            s_bus.frames_bad++;
+            off++;
+            continue;
+        }
+        if (next == bus->tail) {
+            s_bus.frames_bad += flen;   // 事件队列溢出, 视为丢帧
+        } else {
+            SimEvent_t *e = &bus->evt[bus->head];
+            e->t_cmd_start = t_start + off * bt;
+            e->t_apply = t_start + (off + flen) * bt + EMM_SIM_CMD_LATENCY_US;
+            e->len = flen;
+            memcpy(e->data, &data[off], flen);
+            bus->head = next;
+        }
+        off = (uint16_t)(off + flen);
+    }
+    if (off < len) {
+        s_bus.frames_bad += (uint32_t)(len - off);
+    }
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Emm_Sim_Init(UART_HandleTypeDef *huart, const uint8_t *addrs, uint8_t count)
+{
+    memset(s_drv, 0, sizeof(s_drv));
+    memset(s_if, 0, sizeof(s_if));
+    s_if_count = 0;
+    s_addr_count = 0;
+    Emm_Sim_Attach(huart, addrs, count);
+}
+
+void Emm_Sim_Attach(UART_HandleTypeDef *huart, const uint8_t *addrs, uint8_t count)
+{
+    static uint8_t hooked = 0;
+    SimBusIf_t *bus = NULL;
+    uint8_t i;
+
+    if (addrs == NULL) {
+        addrs = s_default_addrs;
+        count = (uint8_t)sizeof(s_default_addrs);
+    }
+
+    bus = find_bus(huart);
+    if (bus == NULL) {
+        if (s_if_count >= EMM_SIM_MAX_BUSES) {
+            return;
+        }
+        bus = &s_if[s_if_count++];
+        bus->huart = huart;
+        Host_UART_Set_Tx_Sink(huart, sim_tx_sink, bus);
+    }
+
+    for (i = 0; i < count && s_addr_count < EMM_SIM_MAX_DRIVERS; i++) {
+        SimDriver_t *d = &s_drv[addrs[i]];
+        if (d->present) {
+            continue;
+        }
+        s_addr_list[s_addr_count++] = addrs[i];
+        d->huart = huart;
+        d->present = true;
+        d->enabled = true;
+        d->is_wheel = (addrs[i] != GRIPPER_LIFT_MOTOR_ADDR);
+        d->stats.addr = addrs[i];
+    }
+
+    if (!hooked) {
+        Host_Register_Tick_Hook(sim_tick);
+        hooked = 1;
+    }
+    Emm_Sim_Reset();
+}
+
+void Emm_Sim_Reset(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_addr_count; i++) {
+        SimDriver_t *d = &s_drv[s_addr_list[i]];
+        d->pos = d->vel = d->target = 0.0;
+        d->mode = SIM_MODE_IDLE;
+        d->staged = false;
+        d->latency_open = false;
+        d->tx_free_us = 0;
+        memset(&d->stats, 0, sizeof(d->stats));
+        d->stats.addr = s_addr_list[i];
+    }
+    memset(&s_bus, 0, sizeof(s_bus));
+    s_group_open = false;
+    s_group_n = 0;
+    for (i = 0; i < s_if_count; i++) {
+        s_if[i].head = s_if[i].tail = 0;
+        s_if[i].rx_end_us = 0;
+        s_if[i].rx_addr = 0;
+    }
+    s_last_tick_us = Host_Clock_Now_us();
+}
+
+int32_t Emm_Sim_Get_Position(uint8_t addr)
+{
+    return s_drv[addr].present ? (int32_t)lround(s_drv[addr].pos) : 0;
+}
+
+float Emm_Sim_Get_Velocity(uint8_t addr)
+{
+    return s_drv[addr].present ? (float)s_drv[addr].vel : 0.0f;
+}
+
+void Emm_Sim_Set_Stall(uint8_t addr, bool stalled)
+{
+    s_drv[addr].stalled = stalled;
+}
+
+const EmmSimDriverStats_t *Emm_Sim_Get_Driver_Stats(uint8_t addr)
+{
+    return s_drv[addr].present ? &s_drv[addr].stats : NULL;
+}
+
+const EmmSimBusStats_t *Emm_Sim_Get_Bus_Stats(void)
+{
+    group_close();
+    return &s_bus;
+}
+
+void Emm_Sim_Print_Report(FILE *out, uint64_t elapsed_us)
+{
+    const EmmSimBusStats_t *bus = Emm_Sim_Get_Bus_Stats();
+    double el = elapsed_us ? (double)elapsed_us : 1.0;
+    uint8_t i;
+
+    fprintf(out, "emm_sim: frames=%u bad_bytes=%u replies=%u collisions=%u sync=%u\n",
+            bus->frames_rx, bus->frames_bad, bus->replies_tx, bus->reply_collisions, bus->sync_triggers);
+    for (i = 0; i < s_if_count; i++) {
+        UART_HandleTypeDef *h = s_if[i].huart;
+        double rx_us = (double)h->host.stat_rx_bytes * Host_UART_Wire_Time_us(h, 1);
+        fprintf(out, "emm_sim: bus %u tx_util=%.1f%% rx_util=%.1f%%\n",
+                (unsigned)i, 100.0 * h->host.stat_tx_busy_us / el, 100.0 * rx_us / el);
+    }
+    fprintf(out, "emm_sim: wheel start skew avg=%.0fus max=%uus over %u groups\n",
+            bus->start_groups ? (double)bus->start_skew_sum_us / bus->start_groups : 0.0,
+            bus->start_skew_max_us, bus->start_groups);
+    for (i = 0; i < s_addr_count; i++) {
+        const EmmSimDriverStats_t *s = &s_drv[s_addr_list[i]].stats;
+        fprintf(out, "  addr %u: cmds=%u moves=%u arrivals=%u latency avg=%.0fus max=%uus busy=%.1fms\n",
+                s->addr, s->cmd_count, s->move_count, s->arrive_count,
+                s->move_count ? (double)s->latency_sum_us / s->move_count : 0.0,
+                s->latency_max_us, s->busy_us / 1000.0);
+    }
+}
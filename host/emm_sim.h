@@ -0,0 +1,104 @@
+/**
+  ******************************************************************************
+  * @file    emm_sim.h
+  * @brief   Emm_V5步进闭环驱动器总线模拟器 (主机端)
+  * @details 挂接在主机HAL替身的UART上, 按Emm_V5.0串口协议解析命令并回复:
+  *          - 位置/速度模式, 含加减速曲线 (每(256-acc)*50us 变化1RPM)
+  *          - 多机同步标志snF与广播同步触发 (地址0)
+  *          - 命令应答、到位返回、参数读取(S_CPOS/S_VEL/S_PERR/S_FLAG/S_VBUS等)
+  *          - 按波特率计算的字节时序; 同一驱动器的回复依次发出,
+  *            不同驱动器的回复在RX线上重叠时两帧均损坏并计入reply_collisions
+  *          默认模拟四个轮子(地址1~4)与升降电机(GRIPPER_LIFT_MOTOR_ADDR)
+  ******************************************************************************
+  */
+
+#ifndef __EMM_SIM_H
+#define __EMM_SIM_H
+
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+
+/* ==================== 模拟参数 ==================== */
+
+#define EMM_SIM_MAX_DRIVERS         8
+#define EMM_SIM_MAX_BUSES           3
+#define EMM_SIM_PULSES_PER_REV      3200        // 16细分
+#define EMM_SIM_COUNTS_PER_REV      65536       // 位置/误差读数单位
+#define EMM_SIM_CMD_LATENCY_US      150         // 驱动器解析命令耗时
+#define EMM_SIM_REPLY_LATENCY_US    100         // 命令处理完到开始回复
+#define EMM_SIM_VBUS_MV             12000       // 总线电压
+#define EMM_SIM_FOLLOW_LAG_US       2000        // S_PERR跟随误差: 实际位置落后实时设定位置的时间
+#define EMM_SIM_HOME_MIN_US         100000      // 回零最短耗时: 碰撞/限位检测与退让, 已在零点也需要
+#define EMM_SIM_EVENT_QUEUE         64
+
+/* ==================== 统计数据 ==================== */
+
+typedef struct {
+    uint8_t  addr;
+    uint32_t cmd_count;             // 收到的命令帧数
+    uint32_t move_count;            // 启动的运动次数
+    uint32_t arrive_count;          // 到位次数
+    uint64_t latency_sum_us;        // 命令开始发送 -> 电机开始运动
+    uint32_t latency_max_us;
+    uint64_t busy_us;               // 电机处于运动状态的时间
+} EmmSimDriverStats_t;
+
+typedef struct {
+    uint32_t frames_rx;             // MCU -> 驱动器 帧数
+    uint32_t frames_bad;            // 无法解析的字节数
+    uint32_t replies_tx;            // 驱动器 -> MCU 帧数
+    uint32_t reply_collisions;      // 两个驱动器的回复在RX线上重叠的次数 (两帧均损坏)
+    uint32_t sync_triggers;         // 同步触发次数
+    uint32_t start_groups;          // 车轮同时启动批次数
+    uint64_t start_skew_sum_us;     // 车轮启动时间差累计
+    uint32_t start_skew_max_us;
+} EmmSimBusStats_t;
+
+/* ==================== 函数声明 ==================== */
+
+/**
+ * @brief 清除全部模拟驱动器, 并在指定串口上挂接模拟驱动器
+ * @param huart 电机总线串口 (通常为huart1)
+ * @param addrs 驱动器地址列表, NULL表示使用默认的四轮+升降
+ * @param count 地址数量
+ */
+void Emm_Sim_Init(UART_HandleTypeDef *huart, const uint8_t *addrs, uint8_t count);
+
+/**
+ * @brief 在(另一路)串口上追加挂接模拟驱动器, 已挂接的地址忽略
+ * @note 每路总线独立排队与回复, 广播帧只作用于本路驱动器
+ */
+void Emm_Sim_Attach(UART_HandleTypeDef *huart, const uint8_t *addrs, uint8_t count);
+
+/**
+ * @brief 清零所有驱动器位置与统计数据
+ */
+void Emm_Sim_Reset(void);
+
+/**
+ * @brief 读取驱动器当前位置
+ * @return 位置 (脉冲, 3200/圈), 地址不存在时返回0
+ */
+int32_t Emm_Sim_Get_Position(uint8_t addr);
+
+/**
+ * @brief 读取驱动器当前转速
+ * @return 转速 (RPM, 带符号)
+ */
+float Emm_Sim_Get_Velocity(uint8_t addr);
+
+/**
+ * @brief 设置堵转状态 (用于测试堵转保护处理)
+ */
+void Emm_Sim_Set_Stall(uint8_t addr, bool stalled);
+
+const EmmSimDriverStats_t *Emm_Sim_Get_Driver_Stats(uint8_t addr);
+const EmmSimBusStats_t *Emm_Sim_Get_Bus_Stats(void);
+
+/**
+ * @brief 输出延迟与总线占用报告
+ * @param elapsed_us 统计区间长度, 用于计算总线占用率
+ */
+void Emm_Sim_Print_Report(FILE *out, uint64_t elapsed_us);
+
+#endif /* __EMM_SIM_H */
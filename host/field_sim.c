@@ -0,0 +1,264 @@
+/**
+  ******************************************************************************
+  * @file    field_sim.c
+  * @brief   场地模拟器 (主机端) - 车体位姿、DMP航向与LubanCat视觉推流
+  ******************************************************************************
+  */
+
+#include "field_sim.h"
+#include "host_board.h"
+#include "emm_sim.h"
+#include "motor.h"
+#include "usart.h"
+
+#include <math.h>
+#include <string.h>
+
+/* ==================== 私有类型 ==================== */
+
+typedef struct {
+    bool  present;
+    float x_mm;
+    float y_mm;
+} FieldObject_t;
+
+/* ==================== 私有变量 ==================== */
+
+static const uint8_t s_wheel_addr[MOTOR_WHEEL_COUNT] = {
+    MOTOR_WHEEL_ADDR_FL, MOTOR_WHEEL_ADDR_FR, MOTOR_WHEEL_ADDR_RL, MOTOR_WHEEL_ADDR_RR
+};
+static const int8_t s_wheel_sign[MOTOR_WHEEL_COUNT] = {
+    MOTOR_WHEEL_SIGN_FL, MOTOR_WHEEL_SIGN_FR, MOTOR_WHEEL_SIGN_RL, MOTOR_WHEEL_SIGN_RR
+};
+
+static double   s_x, s_y, s_th;                 // 场地位姿 (mm, mm, rad)
+static int32_t  s_last_pos[MOTOR_WHEEL_COUNT];  // 上次积分时的车轮脉冲
+static uint64_t s_last_step_us;
+
+static FieldObject_t s_obj[VIS_OBJ_COUNT];
+
+static bool     s_streaming;
+static uint8_t  s_task, s_color, s_fps;
+static uint16_t s_seq;
+static uint64_t s_next_capture_us;
+static uint32_t s_frames_sent;
+static uint32_t s_rand = 12345U;
+
+/* ==================== 私有函数 ==================== */
+
+static void latch_wheels(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        s_last_pos[i] = Emm_Sim_Get_Position(s_wheel_addr[i]);
+    }
+}
+
+/**
+ * @brief 四轮位移增量按麦克纳姆正运动学积分位姿 (chassis_ik的逆, 车体系y左)
+ */
+static void integrate_pose(void)
+{
+    const double mm_per_pulse = 3.14159265358979 * MOTOR_WHEEL_DIAMETER_MM / MOTOR_PULSES_PER_REV;
+    const double k_rot = MOTOR_CHASSIS_HALF_L_MM + MOTOR_CHASSIS_HALF_W_MM;
+    double w[MOTOR_WHEEL_COUNT];
+    double fwd, left, dth, mid;
+    uint8_t i;
+
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        int32_t pos = Emm_Sim_Get_Position(s_wheel_addr[i]);
+        w[i] = (double)(pos - s_last_pos[i]) * s_wheel_sign[i] * mm_per_pulse;
+        s_last_pos[i] = pos;
+    }
+    fwd  = ( w[0] + w[1] + w[2] + w[3]) / 4.0;
+    left = (-w[0] + w[1] + w[2] - w[3]) / 4.0;
+    dth  = (-w[0] + w[1] - w[2] + w[3]) / (4.0 * k_rot);
+
+    // 场地系y右, 航向逆时针: 车头方向(cos, -sin), 车体左方(-sin, -cos)
+    mid = s_th + dth / 2.0;
+    s_x += fwd * cos(mid) - left * sin(mid);
+    s_y += -fwd * sin(mid) - left * cos(mid);
+    s_th += dth;
+}
+
+static uint8_t task_to_obj(uint8_t task, uint8_t color)
+{
+    switch (task) {
+        case TASK_IDENTIFY_MATERIAL:
+            if (color == COLOR_RED)   return VIS_OBJ_RED;
+            if (color == COLOR_GREEN) return VIS_OBJ_GREEN;
+            if (color == COLOR_BLUE)  return VIS_OBJ_BLUE;
+            return VIS_OBJ_COUNT;
+        case TASK_PLATFORM: return VIS_OBJ_PLATFORM;
+        case TASK_SLOT:     return VIS_OBJ_SLOT;
+        default:            return VIS_OBJ_COUNT;
+    }
+}
+
+static int noise_px(void)
+{
+    s_rand = s_rand * 1103515245U + 12345U;
+    return (int)((s_rand >> 16) % (2U * FIELD_SIM_CAM_NOISE_PX + 1U)) - FIELD_SIM_CAM_NOISE_PX;
+}
+
+/**
+ * @brief 当前位姿下采集一帧, 延迟FIELD_SIM_CAM_LATENCY_MS后开始发送
+ */
+static void camera_capture(uint64_t now)
+{
+    uint8_t obj = task_to_obj(s_task, s_color);
+    uint8_t f[16];
+    uint8_t found = 0, sum = 0, i;
+    long x_px = 0, y_px = 0;
+
+    if (obj < VIS_OBJ_COUNT && s_obj[obj].present) {
+        double dx = s_obj[obj].x_mm - s_x;
+        double dy = s_obj[obj].y_mm - s_y;
+        double fwd = dx * cos(s_th) - dy * sin(s_th);
+        double right = dx * sin(s_th) + dy * cos(s_th);
+
+        x_px = lround(FIELD_SIM_CAM_CX_PX + right / FIELD_SIM_CAM_MM_PER_PX) + noise_px();
+        y_px = lround(FIELD_SIM_CAM_CY_PX - fwd / FIELD_SIM_CAM_MM_PER_PX) + noise_px();
+        if (x_px >= 0 && x_px < FIELD_SIM_CAM_W_PX && y_px >= 0 && y_px < FIELD_SIM_CAM_H_PX) {
+            found = 1;
+        } else {
+            x_px = y_px = 0;
+        }
+    }
+
+    f[0] = VISUAL_STREAM_HEAD1;
+    f[1] = VISUAL_STREAM_HEAD2;
+    f[2] = 12;
+    f[3] = VISUAL_STREAM_TYPE_DET;
+    f[4] = (uint8_t)s_seq;
+    f[5] = (uint8_t)(s_seq >> 8);
+    f[6] = (uint8_t)FIELD_SIM_CAM_LATENCY_MS;
+    f[7] = (uint8_t)(FIELD_SIM_CAM_LATENCY_MS >> 8);
+    f[8] = s_task;
+    f[9] = s_color;
+    f[10] = found;
+    f[11] = (uint8_t)x_px;
+    f[12] = (uint8_t)(x_px >> 8);
+    f[13] = (uint8_t)y_px;
+    f[14] = (uint8_t)(y_px >> 8);
+    for (i = 2; i < 15; i++) {
+        sum = (uint8_t)(sum + f[i]);
+    }
+    f[15] = sum;
+
+    s_seq++;
+    s_frames_sent++;
+    Host_UART_Feed_Rx(&huart3, f, sizeof(f), now + FIELD_SIM_CAM_LATENCY_MS * 1000ULL);
+}
+
+static void field_tick(uint64_t now)
+{
+    if (now - s_last_step_us >= FIELD_SIM_STEP_US) {
+        s_last_step_us = now;
+        integrate_pose();
+    }
+    if (s_streaming && now >= s_next_capture_us) {
+        s_next_capture_us += 1000000ULL / s_fps;
+        if (s_next_capture_us <= now) {
+            s_next_capture_us = now + 1000000ULL / s_fps;
+        }
+        integrate_pose();
+        camera_capture(now);
+    }
+}
+
+/**
+ * @brief USART3发送汇聚点: 解析推流控制帧 A5 5A 04 cmd task color fps sum
+ */
+static void camera_tx_sink(void *ctx, const uint8_t *data, uint16_t len,
+                           uint64_t t_start, uint64_t t_end)
+{
+    uint16_t i;
+
+    (void)ctx;
+    (void)t_start;
+    for (i = 0; i + 8U <= len; i++) {
+        uint8_t sum;
+
+        if (data[i] != VISUAL_STREAM_HEAD1 || data[i + 1U] != VISUAL_STREAM_HEAD2 || data[i + 2U] != 4U) {
+            continue;
+        }
+        sum = (uint8_t)(data[i + 2U] + data[i + 3U] + data[i + 4U] + data[i + 5U] + data[i + 6U]);
+        if (sum != data[i + 7U]) {
+            continue;
+        }
+        switch (data[i + 3U]) {
+            case VISUAL_STREAM_CMD_START:
+                s_task = data[i + 4U];
+                s_color = data[i + 5U];
+                s_fps = data[i + 6U] ? data[i + 6U] : VISUAL_STREAM_DEFAULT_FPS;
+                s_seq = 0;
+                s_streaming = true;
+                s_next_capture_us = t_end;
+                break;
+            case VISUAL_STREAM_CMD_STOP:
+                s_streaming = false;
+                break;
+            default:
+                break;
+        }
+        i += 7U;
+    }
+}
+
+static float field_yaw_deg(void)
+{
+    double deg = fmod(s_th * 180.0 / 3.14159265358979, 360.0);
+
+    if (deg > 180.0)   deg -= 360.0;
+    if (deg <= -180.0) deg += 360.0;
+    return (float)deg;
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Field_Sim_Init(void)
+{
+    Field_Sim_Reset_Pose();
+    Field_Sim_Clear_Objects();
+    s_streaming = false;
+    s_frames_sent = 0;
+    Host_UART_Set_Tx_Sink(&huart3, camera_tx_sink, NULL);
+    Host_IMU_Set_Source(field_yaw_deg);
+    Host_Register_Tick_Hook(field_tick);
+}
+
+void Field_Sim_Reset_Pose(void)
+{
+    s_x = s_y = s_th = 0.0;
+    latch_wheels();
+    s_last_step_us = Host_Clock_Now_us();
+}
+
+void Field_Sim_Get_Pose(float *x_mm, float *y_mm, float *theta_deg)
+{
+    integrate_pose();
+    *x_mm = (float)s_x;
+    *y_mm = (float)s_y;
+    *theta_deg = field_yaw_deg();
+}
+
+void Field_Sim_Set_Object(VisualObject_t obj, float x_mm, float y_mm)
+{
+    if (obj < VIS_OBJ_COUNT) {
+        s_obj[obj].present = true;
+        s_obj[obj].x_mm = x_mm;
+        s_obj[obj].y_mm = y_mm;
+    }
+}
+
+void Field_Sim_Clear_Objects(void)
+{
+    memset(s_obj, 0, sizeof(s_obj));
+}
+
+uint32_t Field_Sim_Frames_Sent(void)
+{
+    return s_frames_sent;
+}
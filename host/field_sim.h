@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    field_sim.h
+  * @brief   场地模拟器 (主机端) - 车体位姿、DMP航向与LubanCat视觉推流
+  * @details 每个时钟步由四轮模拟驱动器位置按麦克纳姆正运动学积分车体位姿:
+  *          - 作为MPU6050 DMP替身的航向数据源
+  *          - 在USART3上模拟LubanCat: 解析推流控制帧, 按帧率发送单目标检测帧(type=0x01),
+  *            目标像素由目标物体相对车体的位置与相机比例换算, 带采集延迟与±1像素噪声
+  *          场地坐标系: x前(原点处车头方向), y右, 航向逆时针为正
+  ******************************************************************************
+  */
+
+#ifndef __FIELD_SIM_H
+#define __FIELD_SIM_H
+
+#include "stm32f4xx_hal.h"
+#include "visual_stream.h"
+
+/* ==================== 模拟参数 ==================== */
+
+#define FIELD_SIM_STEP_US           1000        // 位姿积分步长
+#define FIELD_SIM_CAM_CX_PX         320         // 机械爪正对目标时目标的像素坐标
+#define FIELD_SIM_CAM_CY_PX         240
+#define FIELD_SIM_CAM_W_PX          640
+#define FIELD_SIM_CAM_H_PX          480
+#define FIELD_SIM_CAM_MM_PER_PX     0.45f       // 物块平面的像素比例
+#define FIELD_SIM_CAM_LATENCY_MS    45          // 采集到开始发送
+#define FIELD_SIM_CAM_NOISE_PX      1           // 坐标噪声幅度
+
+// 名义场地布置 (场地坐标系), 任务替身按此行驶, 基准程序在其上叠加物块摆放偏差
+#define FIELD_MATERIAL_X_MM         400.0f      // 物料台前抓取站的前向位置
+#define FIELD_BLOCK_PITCH_MM        70.0f       // 红/绿/蓝物块横向间距, 绿色居中, 红色在左
+
+/* ==================== 函数声明 ==================== */
+
+/**
+ * @brief 挂接到时钟步与USART3, 并设为DMP航向数据源
+ * @note 在Host_Board_Init与Emm_Sim_Init之后调用
+ */
+void Field_Sim_Init(void);
+
+/**
+ * @brief 把当前位置设为场地原点 (x=y=0, 航向0)
+ */
+void Field_Sim_Reset_Pose(void);
+
+/**
+ * @brief 读取车体位姿 (场地坐标系)
+ */
+void Field_Sim_Get_Pose(float *x_mm, float *y_mm, float *theta_deg);
+
+/**
+ * @brief 放置目标物体: 机械爪正对该物体时车体所在位置 (场地坐标系)
+ */
+void Field_Sim_Set_Object(VisualObject_t obj, float x_mm, float y_mm);
+
+/**
+ * @brief 移除全部目标物体
+ */
+void Field_Sim_Clear_Objects(void);
+
+/**
+ * @brief 已发送的检测帧数
+ */
+uint32_t Field_Sim_Frames_Sent(void);
+
+#endif /* __FIELD_SIM_H */
@@ -0,0 +1,675 @@
+/**
+  ******************************************************************************
+  * @file    hal_shim.c
+  * @brief   主机端HAL替身实现 (虚拟时钟 + UART/I2C/TIM/DMA 行为模型)
+  ******************************************************************************
+  */
+
+#include "stm32f4xx_hal.h"
+
+/* ==================== 私有变量 ==================== */
+
+#define HOST_MAX_UART       6
+#define HOST_MAX_TIM        4
+#define HOST_MAX_HOOK       8
+
+GPIO_TypeDef  Host_GPIOA, Host_GPIOB, Host_GPIOC, Host_GPIOD, Host_GPIOE;
+USART_TypeDef Host_USART1 = {1}, Host_USART2 = {2}, Host_USART3 = {3};
+TIM_TypeDef   Host_TIM1 = {1};
+uint8_t       Host_BKPSRAM[4096];           // 进程内保持, 模拟MCU复位后备份SRAM不丢失
+uint8_t       Host_FLASH[HOST_FLASH_SIZE];  // 进程内保持, 模拟片上Flash
+uint16_t      Host_FLASHSIZE_KB = HOST_FLASH_SIZE / 1024U;
+
+static uint64_t s_now_us = 0;
+static uint8_t  s_advancing = 0;
+
+static UART_HandleTypeDef *s_uart[HOST_MAX_UART];
+static uint8_t             s_uart_count = 0;
+static TIM_HandleTypeDef  *s_tim[HOST_MAX_TIM];
+static uint8_t             s_tim_count = 0;
+static Host_TickHook_t     s_hook[HOST_MAX_HOOK];
+static uint8_t             s_hook_count = 0;
+
+/* ==================== 私有函数 ==================== */
+
+static uint32_t uart_byte_time_us(const UART_HandleTypeDef *huart)
+{
+    uint32_t baud = huart->Init.BaudRate ? huart->Init.BaudRate : 115200U;
+    // 1起始位 + 8数据位 + 1停止位
+    return (10U * 1000000U + baud - 1U) / baud;
+}
+
+static void uart_rx_deliver(UART_HandleTypeDef *huart, uint8_t byte)
+{
+    Host_UartState_t *st = &huart->host;
+
+    st->stat_rx_bytes++;
+
+    if (st->rx_hook != NULL) {
+        st->rx_hook(st->rx_ctx, byte);
+        return;
+    }
+
+    if (st->rx_mode == 0 || st->rx_buf == NULL) {
+        return;  // 未启动接收, 字节丢失(与真实硬件的溢出行为一致)
+    }
+
+    st->rx_buf[st->rx_pos++] = byte;
+    if (huart->hdmarx != NULL) {
+        huart->hdmarx->host_ndtr = (uint32_t)(st->rx_size - st->rx_pos);
+    }
+
+    bool circular = (huart->hdmarx != NULL) && (huart->hdmarx->Init.Mode == DMA_CIRCULAR);
+
+    if (st->rx_mode == 3 && st->rx_pos == st->rx_size / 2U) {
+        HAL_UARTEx_RxEventCallback(huart, st->rx_pos);
+    } else if (st->rx_mode == 2 && circular && st->rx_pos == st->rx_size / 2U) {
+        HAL_UART_RxHalfCpltCallback(huart);
+    }
+
+    if (st->rx_pos >= st->rx_size) {
+        uint8_t mode = st->rx_mode;
+        st->rx_pos = 0;
+        if (huart->hdmarx != NULL) {
+            huart->hdmarx->host_ndtr = st->rx_size;
+        }
+        if (!(mode >= 2 && circular)) {
+            st->rx_mode = 0;
+            huart->RxState = HAL_UART_STATE_READY;
+        }
+        if (mode == 3) {
+            HAL_UARTEx_RxEventCallback(huart, st->rx_size);
+        } else {
+            HAL_UART_RxCpltCallback(huart);
+        }
+    }
+}
+
+static void uart_rx_idle(UART_HandleTypeDef *huart)
+{
+    Host_UartState_t *st = &huart->host;
+
+    if (st->idle_hook != NULL) {
+        st->idle_hook(st->rx_ctx);
+    }
+
+    if (st->rx_hook == NULL && st->rx_mode == 3) {
+        bool circular = (huart->hdmarx != NULL) && (huart->hdmarx->Init.Mode == DMA_CIRCULAR);
+        uint16_t pos = st->rx_pos;
+        if (!circular) {
+            st->rx_mode = 0;
+            st->rx_pos = 0;
+            huart->RxState = HAL_UART_STATE_READY;
+        }
+        HAL_UARTEx_RxEventCallback(huart, pos);
+    }
+}
+
+static void uart_process(UART_HandleTypeDef *huart)
+{
+    Host_UartState_t *st = &huart->host;
+
+    // 线上到达的字节
+    while (st->rx_tail != st->rx_head && st->rx_time[st->rx_tail] <= s_now_us) {
+        uint8_t b = st->rx_fifo[st->rx_tail];
+        st->rx_last_byte_us = st->rx_time[st->rx_tail];
+        st->rx_tail = (uint16_t)((st->rx_tail + 1U) % HOST_UART_RX_FIFO);
+        st->rx_idle_pending = 1;
+        uart_rx_deliver(huart, b);
+    }
+
+    // 一个字节时间无新数据 -> IDLE (FIFO中可能已有稍后才到达的字节)
+    if (st->rx_idle_pending &&
+        s_now_us >= st->rx_last_byte_us + uart_byte_time_us(huart) &&
+        (st->rx_tail == st->rx_head ||
+         st->rx_time[st->rx_tail] > st->rx_last_byte_us + uart_byte_time_us(huart))) {
+        st->rx_idle_pending = 0;
+        uart_rx_idle(huart);
+    }
+
+    // DMA发送完成
+    if (st->tx_dma_pending && s_now_us >= st->tx_dma_done_us) {
+        st->tx_dma_pending = 0;
+        huart->gState = HAL_UART_STATE_READY;
+        HAL_UART_TxCpltCallback(huart);
+    }
+}
+
+static uint64_t next_event_us(uint64_t limit)
+{
+    uint64_t next = limit;
+    uint8_t i;
+
+    for (i = 0; i < s_uart_count; i++) {
+        Host_UartState_t *st = &s_uart[i]->host;
+        if (st->rx_tail != st->rx_head && st->rx_time[st->rx_tail] < next) {
+            next = st->rx_time[st->rx_tail];
+        }
+        if (st->rx_idle_pending) {
+            uint64_t t = st->rx_last_byte_us + uart_byte_time_us(s_uart[i]);
+            if (t < next) next = t;
+        }
+        if (st->tx_dma_pending && st->tx_dma_done_us < next) {
+            next = st->tx_dma_done_us;
+        }
+    }
+    for (i = 0; i < s_tim_count; i++) {
+        TIM_HandleTypeDef *htim = s_tim[i];
+        if (htim->host_it_enabled && htim->host_period_us && htim->host_next_update_us < next) {
+            next = htim->host_next_update_us;
+        }
+    }
+    return next;
+}
+
+static void process_events(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_uart_count; i++) {
+        uart_process(s_uart[i]);
+    }
+    for (i = 0; i < s_tim_count; i++) {
+        TIM_HandleTypeDef *htim = s_tim[i];
+        while (htim->host_it_enabled && htim->host_period_us && htim->host_next_update_us <= s_now_us) {
+            htim->host_next_update_us += htim->host_period_us;
+            HAL_TIM_PeriodElapsedCallback(htim);
+        }
+    }
+    for (i = 0; i < s_hook_count; i++) {
+        s_hook[i](s_now_us);
+    }
+}
+
+static HAL_StatusTypeDef uart_start_tx(UART_HandleTypeDef *huart, const uint8_t *pData,
+                                       uint16_t Size, uint64_t *t_end)
+{
+    Host_UartState_t *st = &huart->host;
+    uint64_t t_start;
+
+    if (pData == NULL || Size == 0U) {
+        return HAL_ERROR;
+    }
+    if (huart->gState == HAL_UART_STATE_BUSY_TX) {
+        return HAL_BUSY;
+    }
+
+    t_start = (st->tx_busy_until_us > s_now_us) ? st->tx_busy_until_us : s_now_us;
+    *t_end = t_start + Host_UART_Wire_Time_us(huart, Size);
+    st->tx_busy_until_us = *t_end;
+    st->stat_tx_bytes += Size;
+    st->stat_tx_busy_us += *t_end - t_start;
+
+    if (st->tx_sink != NULL) {
+        st->tx_sink(st->tx_ctx, pData, Size, t_start, *t_end);
+    }
+    return HAL_OK;
+}
+
+/* ==================== 虚拟时钟 ==================== */
+
+void Host_Clock_Reset(void)
+{
+    s_now_us = 0;
+}
+
+uint64_t Host_Clock_Now_us(void)
+{
+    return s_now_us;
+}
+
+void Host_Clock_Advance_us(uint64_t us)
+{
+    uint64_t target = s_now_us + us;
+
+    if (s_advancing) {
+        // 在回调中调用延时: 只推进时间, 不重入事件处理
+        s_now_us = target;
+        return;
+    }
+
+    s_advancing = 1;
+    do {
+        uint64_t step = s_now_us + HOST_MAX_STEP_US;
+        uint64_t next = next_event_us(step < target ? step : target);
+        if (next < s_now_us) next = s_now_us;
+        s_now_us = next;
+        process_events();
+    } while (s_now_us < target);
+    s_advancing = 0;
+}
+
+uint8_t Host_Register_Tick_Hook(Host_TickHook_t hook)
+{
+    if (s_hook_count >= HOST_MAX_HOOK) {
+        return 1;
+    }
+    s_hook[s_hook_count++] = hook;
+    return 0;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    Host_Clock_Advance_us((uint64_t)Delay * 1000U);
+}
+
+uint32_t HAL_GetTick(void)
+{
+    // 计入轮询开销, 保证 while(HAL_GetTick() - t < x) 类循环能够前进
+    Host_Clock_Advance_us(HOST_GETTICK_COST_US);
+    return (uint32_t)(s_now_us / 1000U);
+}
+
+void HAL_IncTick(void)
+{
+    Host_Clock_Advance_us(1000U);
+}
+
+/* ==================== NVIC ==================== */
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    UNUSED(IRQn);
+    UNUSED(PreemptPriority);
+    UNUSED(SubPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    UNUSED(IRQn);
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    UNUSED(IRQn);
+}
+
+/* ==================== GPIO ==================== */
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState == GPIO_PIN_SET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR ^= GPIO_Pin;
+}
+
+/* ==================== UART ==================== */
+
+void Host_UART_Register(UART_HandleTypeDef *huart)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_uart_count; i++) {
+        if (s_uart[i] == huart) return;
+    }
+    if (s_uart_count < HOST_MAX_UART) {
+        s_uart[s_uart_count++] = huart;
+    }
+}
+
+uint32_t Host_UART_Wire_Time_us(const UART_HandleTypeDef *huart, uint16_t len)
+{
+    uint32_t baud = huart->Init.BaudRate ? huart->Init.BaudRate : 115200U;
+    return (uint32_t)(((uint64_t)len * 10U * 1000000U + baud - 1U) / baud);
+}
+
+void Host_UART_Set_Tx_Sink(UART_HandleTypeDef *huart, Host_UART_TxSink_t sink, void *ctx)
+{
+    Host_UART_Register(huart);
+    huart->host.tx_sink = sink;
+    huart->host.tx_ctx = ctx;
+}
+
+void Host_UART_Set_Rx_Hooks(UART_HandleTypeDef *huart, Host_UART_RxHook_t rx,
+                            Host_UART_IdleHook_t idle, void *ctx)
+{
+    Host_UART_Register(huart);
+    huart->host.rx_hook = rx;
+    huart->host.idle_hook = idle;
+    huart->host.rx_ctx = ctx;
+}
+
+/**
+ * @brief 外设向MCU发送字节, 按波特率排队到达
+ * @param not_before_us 第一个字节最早开始发送的时间
+ * @return 实际入队字节数 (FIFO满时截断)
+ */
+uint16_t Host_UART_Feed_Rx(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len,
+                           uint64_t not_before_us)
+{
+    Host_UartState_t *st = &huart->host;
+    uint32_t bt = uart_byte_time_us(huart);
+    uint64_t t = st->rx_line_free_us;
+    uint16_t i;
+
+    Host_UART_Register(huart);
+    if (t < not_before_us) t = not_before_us;
+    if (t < s_now_us) t = s_now_us;
+
+    for (i = 0; i < len; i++) {
+        uint16_t next = (uint16_t)((st->rx_head + 1U) % HOST_UART_RX_FIFO);
+        if (next == st->rx_tail) break;
+        t += bt;
+        st->rx_fifo[st->rx_head] = data[i];
+        st->rx_time[st->rx_head] = t;
+        st->rx_head = next;
+    }
+    st->rx_line_free_us = t;
+    return i;
+}
+
+/**
+ * @brief 损坏尚未到达MCU、结束时刻晚于after_us的字节 (模拟两个发送者在RX线上冲突)
+ */
+void Host_UART_Garble_Rx(UART_HandleTypeDef *huart, uint64_t after_us)
+{
+    Host_UartState_t *st = &huart->host;
+    uint16_t i;
+
+    for (i = st->rx_tail; i != st->rx_head; i = (uint16_t)((i + 1U) % HOST_UART_RX_FIFO)) {
+        if (st->rx_time[i] > after_us) {
+            st->rx_fifo[i] = 0xFF;
+        }
+    }
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+    Host_UART_Register(huart);
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData,
+                                    uint16_t Size, uint32_t Timeout)
+{
+    uint64_t t_end, t_call = s_now_us;
+    HAL_StatusTypeDef ret;
+
+    UNUSED(Timeout);
+    Host_UART_Register(huart);
+    ret = uart_start_tx(huart, pData, Size, &t_end);
+    if (ret != HAL_OK) {
+        return ret;
+    }
+    // 阻塞直到最后一个字节移出
+    Host_Clock_Advance_us(t_end - s_now_us);
+    huart->host.stat_tx_block_us += s_now_us - t_call;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    uint64_t t_end;
+    HAL_StatusTypeDef ret;
+
+    Host_UART_Register(huart);
+    ret = uart_start_tx(huart, pData, Size, &t_end);
+    if (ret != HAL_OK) {
+        return ret;
+    }
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    huart->host.tx_dma_pending = 1;
+    huart->host.tx_dma_done_us = t_end;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    return HAL_UART_Transmit_DMA(huart, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    uint32_t tickstart = HAL_GetTick();
+    HAL_StatusTypeDef ret = HAL_UART_Receive_IT(huart, pData, Size);
+
+    if (ret != HAL_OK) {
+        return ret;
+    }
+    while (huart->host.rx_mode != 0) {
+        if (HAL_GetTick() - tickstart > Timeout) {
+            HAL_UART_AbortReceive(huart);
+            return HAL_TIMEOUT;
+        }
+    }
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef uart_start_rx(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint8_t mode)
+{
+    if (pData == NULL || Size == 0U) {
+        return HAL_ERROR;
+    }
+    if (huart->RxState == HAL_UART_STATE_BUSY_RX) {
+        return HAL_BUSY;
+    }
+    Host_UART_Register(huart);
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    huart->host.rx_mode = mode;
+    huart->host.rx_buf = pData;
+    huart->host.rx_size = Size;
+    huart->host.rx_pos = 0;
+    if (huart->hdmarx != NULL) {
+        huart->hdmarx->host_ndtr = Size;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    return uart_start_rx(huart, pData, Size, 1);
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    return uart_start_rx(huart, pData, Size, 2);
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    return uart_start_rx(huart, pData, Size, 3);
+}
+
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef *huart)
+{
+    huart->host.tx_dma_pending = 0;
+    huart->gState = HAL_UART_STATE_READY;
+    return HAL_UART_AbortReceive(huart);
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart)
+{
+    huart->host.rx_mode = 0;
+    huart->host.rx_pos = 0;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)      { UNUSED(huart); }
+__weak void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)      { UNUSED(huart); }
+__weak void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *huart)  { UNUSED(huart); }
+__weak void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)       { UNUSED(huart); }
+__weak void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    UNUSED(huart);
+    UNUSED(Size);
+}
+
+/* ==================== I2C ==================== */
+
+// 400kHz, 每字节9位
+#define HOST_I2C_BYTE_US    23U
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    UNUSED(hi2c); UNUSED(DevAddress); UNUSED(pData); UNUSED(Timeout);
+    Host_Clock_Advance_us((uint64_t)(Size + 1U) * HOST_I2C_BYTE_US);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    UNUSED(hi2c); UNUSED(DevAddress); UNUSED(Timeout);
+    memset(pData, 0, Size);
+    Host_Clock_Advance_us((uint64_t)(Size + 1U) * HOST_I2C_BYTE_US);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    UNUSED(hi2c); UNUSED(DevAddress); UNUSED(MemAddress); UNUSED(pData); UNUSED(Timeout);
+    Host_Clock_Advance_us((uint64_t)(Size + 1U + MemAddSize) * HOST_I2C_BYTE_US);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    UNUSED(hi2c); UNUSED(DevAddress); UNUSED(MemAddress); UNUSED(Timeout);
+    memset(pData, 0, Size);
+    Host_Clock_Advance_us((uint64_t)(Size + 2U + MemAddSize) * HOST_I2C_BYTE_US);
+    return HAL_OK;
+}
+
+/* ==================== TIM ==================== */
+
+void Host_TIM_Register(TIM_HandleTypeDef *htim, uint32_t period_us)
+{
+    uint8_t i;
+
+    htim->host_period_us = period_us;
+    for (i = 0; i < s_tim_count; i++) {
+        if (s_tim[i] == htim) return;
+    }
+    if (s_tim_count < HOST_MAX_TIM) {
+        s_tim[s_tim_count++] = htim;
+    }
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    UNUSED(htim); UNUSED(Channel);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    UNUSED(htim); UNUSED(Channel);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+    htim->host_it_enabled = 1;
+    htim->host_next_update_us = s_now_us + htim->host_period_us;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+    htim->host_it_enabled = 0;
+    return HAL_OK;
+}
+
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
+{
+    HAL_TIM_PeriodElapsedCallback(htim);
+}
+
+__weak void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    UNUSED(htim);
+}
+
+/* ==================== PWR / 备份SRAM ==================== */
+
+void HAL_PWR_EnableBkUpAccess(void)
+{
+}
+
+HAL_StatusTypeDef HAL_PWREx_EnableBkUpReg(void)
+{
+    return HAL_OK;
+}
+
+/* ==================== FLASH ==================== */
+
+#define HOST_FLASH_ERASE_US_PER_KB  8000U   // 扇区擦除 (128KB约1s)
+#define HOST_FLASH_PROGRAM_US       16U     // 单字编程
+
+static bool s_flash_locked = true;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    s_flash_locked = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    s_flash_locked = true;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError)
+{
+    uint32_t n;
+
+    *SectorError = 0xFFFFFFFFU;
+    if (s_flash_locked) {
+        return HAL_ERROR;
+    }
+    for (n = 0; n < pEraseInit->NbSectors; n++) {
+        uint32_t sec = pEraseInit->Sector + n;
+        uint32_t off, size;
+
+        // 4 x 16KB, 1 x 64KB, 7 x 128KB
+        if (sec < 4U) {
+            off = sec * 0x4000U;
+            size = 0x4000U;
+        } else if (sec == 4U) {
+            off = 0x10000U;
+            size = 0x10000U;
+        } else if (sec < 12U) {
+            off = (sec - 4U) * 0x20000U;
+            size = 0x20000U;
+        } else {
+            *SectorError = sec;
+            return HAL_ERROR;
+        }
+        memset(&Host_FLASH[off], 0xFF, size);
+        HAL_Delay(size / 1024U * HOST_FLASH_ERASE_US_PER_KB / 1000U);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    uint32_t off = Address - (uint32_t)FLASH_BASE;     // 主机指针截断为32位, 差值仍正确
+    uint32_t w = (uint32_t)Data;
+    uint8_t i;
+
+    if (s_flash_locked || TypeProgram != FLASH_TYPEPROGRAM_WORD || (off & 3U) ||
+        off > HOST_FLASH_SIZE - 4U) {
+        return HAL_ERROR;
+    }
+    // 编程只能把1写成0
+    for (i = 0; i < 4; i++) {
+        Host_FLASH[off + i] &= (uint8_t)(w >> (8U * i));
+    }
+    Host_Clock_Advance_us(HOST_FLASH_PROGRAM_US);
+    return HAL_OK;
+}
@@ -0,0 +1,215 @@
+/**
+  ******************************************************************************
+  * @file    host_board.c
+  * @brief   主机端板级替身实现
+  ******************************************************************************
+  */
+
+#include "host_board.h"
+#include "main.h"
+#include "usart.h"
+#include "i2c.h"
+#include "tim.h"
+#include "dma.h"
+#include "oled.h"
+#include "servo.h"
+#include "inv_mpu.h"
+#include "MPU6050.h"
+#include "emm_bus.h"
+#include "emm_rx.h"
+#include "emm_poll.h"
+#include "visual_stream.h"
+
+/* ==================== 外设句柄 (对应CubeMX生成文件) ==================== */
+
+UART_HandleTypeDef huart1;
+UART_HandleTypeDef huart2;
+UART_HandleTypeDef huart3;
+DMA_HandleTypeDef  hdma_usart1_rx;
+DMA_HandleTypeDef  hdma_usart1_tx;
+DMA_HandleTypeDef  hdma_usart2_rx;
+DMA_HandleTypeDef  hdma_usart2_tx;
+DMA_HandleTypeDef  hdma_usart3_rx;
+DMA_HandleTypeDef  hdma_memtomem_dma2_stream1;
+I2C_HandleTypeDef  hi2c3;
+TIM_HandleTypeDef  htim1;
+
+/* usart.c 中的Emm_V5接收缓冲区 */
+__IO bool    rxFrameFlag = false;
+__IO uint8_t rxCmd[CMD_LEN] = {0};
+__IO uint8_t rxCount = 0;
+volatile bool motor_arrived_flag = false;
+
+/* ==================== 私有变量 ==================== */
+
+static float            s_yaw_deg = 0.0f;
+static Host_YawSource_t s_yaw_src = NULL;
+static float            s_servo_angle[3] = {0};
+
+/* ==================== Emm_V5命令发送 ==================== */
+
+/**
+ * @brief 与usart.c中的同名函数对应, Emm_V5层通过它发送命令
+ * @note 按驱动器地址路由到对应串口的DMA发送队列后立即返回
+ */
+void usart_SendCmd(__IO uint8_t *cmd, uint8_t len)
+{
+    Emm_Bus_Send_Routed((const uint8_t *)cmd, len);
+}
+
+/* ==================== CubeMX初始化函数 ==================== */
+
+static void uart_init(UART_HandleTypeDef *huart, USART_TypeDef *inst, uint32_t baud)
+{
+    memset(huart, 0, sizeof(*huart));
+    huart->Instance = inst;
+    huart->Init.BaudRate = baud;
+    HAL_UART_Init(huart);
+}
+
+void MX_USART1_UART_Init(void)
+{
+    uart_init(&huart1, USART1, HOST_MOTOR_BAUDRATE);
+    huart1.hdmarx = &hdma_usart1_rx;
+    huart1.hdmatx = &hdma_usart1_tx;
+}
+
+void MX_USART2_UART_Init(void)
+{
+    uart_init(&huart2, USART2, HOST_MOTOR_BAUDRATE);
+    huart2.hdmarx = &hdma_usart2_rx;
+    huart2.hdmatx = &hdma_usart2_tx;
+}
+
+void MX_USART3_UART_Init(void)
+{
+    uart_init(&huart3, USART3, HOST_VISION_BAUDRATE);
+    huart3.hdmarx = &hdma_usart3_rx;
+}
+
+void MX_DMA_Init(void)
+{
+    memset(&hdma_usart1_rx, 0, sizeof(hdma_usart1_rx));
+    memset(&hdma_usart1_tx, 0, sizeof(hdma_usart1_tx));
+    hdma_usart1_rx.Init.Mode = DMA_CIRCULAR;
+    hdma_usart1_tx.Init.Mode = DMA_NORMAL;
+    memset(&hdma_usart2_rx, 0, sizeof(hdma_usart2_rx));
+    memset(&hdma_usart2_tx, 0, sizeof(hdma_usart2_tx));
+    hdma_usart2_rx.Init.Mode = DMA_CIRCULAR;
+    hdma_usart2_tx.Init.Mode = DMA_NORMAL;
+    memset(&hdma_usart3_rx, 0, sizeof(hdma_usart3_rx));
+    hdma_usart3_rx.Init.Mode = DMA_CIRCULAR;
+}
+
+void MX_I2C3_Init(void)
+{
+    hi2c3.Init.ClockSpeed = 400000;
+}
+
+void MX_TIM1_Init(void)
+{
+    memset(&htim1, 0, sizeof(htim1));
+    htim1.Instance = TIM1;
+    htim1.Init.Prescaler = 167;         // 168MHz -> 1MHz
+    htim1.Init.Period = 19999;          // 20ms
+    Host_TIM_Register(&htim1, 20000U);  // 50Hz舵机PWM
+}
+
+void HAL_TIM_MspPostInit(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+void MX_GPIO_Init(void)
+{
+}
+
+void Error_Handler(void)
+{
+    while (1) {
+    }
+}
+
+void Host_Board_Init(void)
+{
+    UART_HandleTypeDef *bus[EMM_BUS_MAX_UART];
+    uint8_t i, n;
+
+    Host_Clock_Reset();
+    MX_GPIO_Init();
+    MX_DMA_Init();
+    MX_USART1_UART_Init();
+    MX_USART2_UART_Init();
+    MX_USART3_UART_Init();
+    MX_I2C3_Init();
+    MX_TIM1_Init();
+    Servo_Ramp_Init();
+    Emm_Bus_Init();
+    n = Emm_Bus_Uart_List(bus);
+    for (i = 0; i < n; i++) {
+        Emm_Rx_Init(bus[i]);
+    }
+    Emm_Poll_Init();
+    Visual_Stream_Rx_Init();
+}
+
+/* ==================== MPU6050 DMP替身 ==================== */
+
+void Host_IMU_Set_Yaw(float yaw_deg)
+{
+    s_yaw_deg = yaw_deg;
+}
+
+void Host_IMU_Set_Source(Host_YawSource_t src)
+{
+    s_yaw_src = src;
+}
+
+uint8_t MPU_Init(void)
+{
+    return 0;
+}
+
+uint8_t mpu_dmp_init(void)
+{
+    return 0;
+}
+
+uint8_t mpu_dmp_get_data(float *pitch, float *roll, float *yaw)
+{
+    // DMP FIFO读取约 3ms I2C 时间
+    HAL_Delay(3);
+    *pitch = 0.0f;
+    *roll = 0.0f;
+    *yaw = (s_yaw_src != NULL) ? s_yaw_src() : s_yaw_deg;
+    return 0;
+}
+
+/* ==================== 舵机替身 ==================== */
+
+void Servo_SetAngle1(float angle) { s_servo_angle[0] = angle; }
+void Servo_SetAngle2(float angle) { s_servo_angle[1] = angle; }
+void Servo_SetAngle3(float angle) { s_servo_angle[2] = angle; }
+
+float Host_Servo_Get_Angle(uint8_t channel)
+{
+    return (channel >= 1 && channel <= 3) ? s_servo_angle[channel - 1] : 0.0f;
+}
+
+/* ==================== OLED替身 ==================== */
+
+void OLED_Init(void) {}
+void OLED_Clear(void) {}
+void OLED_DisplayOn(void) {}
+void OLED_DisplayOff(void) {}
+void OLED_SetCursor(uint8_t x, uint8_t y) { (void)x; (void)y; }
+void OLED_ShowChar(uint8_t Line, uint8_t Column, char Char) { (void)Line; (void)Column; (void)Char; }
+void OLED_ShowString(uint8_t Line, uint8_t Column, char *String) { (void)Line; (void)Column; (void)String; }
+void OLED_ShowNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length) { (void)Line; (void)Column; (void)Number; (void)Length; }
+void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Length) { (void)Line; (void)Column; (void)Number; (void)Length; }
+void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length) { (void)Line; (void)Column; (void)Number; (void)Length; }
+void OLED_ShowBinNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length) { (void)Line; (void)Column; (void)Number; (void)Length; }
+void OLED_ShowChinese24x24(uint8_t x, uint8_t y, uint16_t gb_code) { (void)x; (void)y; (void)gb_code; }
+void OLED_ShowChinese24x24String(uint8_t x, uint8_t y, const char *text) { (void)x; (void)y; (void)text; }
+void OLED_ShowChinese16x16(uint8_t x, uint8_t y, uint16_t gb_code) { (void)x; (void)y; (void)gb_code; }
+void OLED_ShowChinese16x16String(uint8_t x, uint8_t y, const char *text) { (void)x; (void)y; (void)text; }
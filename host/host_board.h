@@ -0,0 +1,37 @@
+/**
+  ******************************************************************************
+  * @file    host_board.h
+  * @brief   主机端板级替身 - 外设句柄、CubeMX初始化函数及非HAL模块桩
+  * @details 替代usart.c/i2c.c/tim.c/dma.c、OLED、MPU6050 DMP、舵机驱动,
+  *          使motor.c/gripper.c/visual_comm.c/task.c/task_vision_gripper.c
+  *          及Emm_V5层可以直接在Linux上链接运行
+  ******************************************************************************
+  */
+
+#ifndef __HOST_BOARD_H
+#define __HOST_BOARD_H
+
+#include "stm32f4xx_hal.h"
+
+/* ==================== 板级配置 ==================== */
+
+#define HOST_MOTOR_BAUDRATE     115200U     // Emm_V5驱动器串口波特率
+#define HOST_VISION_BAUDRATE    115200U     // LubanCat视觉串口波特率
+
+/**
+ * @brief 航向角数据源
+ * @note 返回当前yaw(度), 由模拟器提供; 未设置时返回Host_IMU_Set_Yaw()的值
+ */
+typedef float (*Host_YawSource_t)(void);
+
+/**
+ * @brief 初始化虚拟时钟与全部外设句柄
+ * @note 等价于main()中MX_xxx_Init()序列, 须在运行任务逻辑前调用
+ */
+void Host_Board_Init(void);
+
+void  Host_IMU_Set_Yaw(float yaw_deg);
+void  Host_IMU_Set_Source(Host_YawSource_t src);
+float Host_Servo_Get_Angle(uint8_t channel);
+
+#endif /* __HOST_BOARD_H */
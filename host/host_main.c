@@ -0,0 +1,197 @@
+/**
+  ******************************************************************************
+  * @file    host_main.c
+  * @brief   主机端任务基准程序 - 在虚拟时钟上反复运行比赛任务并统计耗时
+  * @details 构建(工程根目录下):
+  *            make -C host
+  *          (缺少的上游源文件自动以host/stubs/下的替身链接, 见host/Makefile)
+  *          运行:
+  *            host/host_mission pickup 1000
+  *            host/host_mission sorting 1000
+  *            host/host_mission inpos 10        (到位窗口校核)
+  *          输出的时间全部为虚拟时间, 与主机性能无关, 可直接对比回归;
+  *          USART1/2上按路由表挂接Emm_V5模拟器, 同时输出命令延迟与总线占用;
+  *          场地模拟器(field_sim)积分车体位姿、提供DMP航向并在USART3上推流,
+  *          每次运行前回到原点并按固定伪随机偏差重新摆放物块
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_board.h"
+#include "emm_sim.h"
+#include "field_sim.h"
+#include "emm_bus.h"
+#include "motor.h"
+#include "gripper.h"
+#include "usart.h"
+#include "task.h"
+#include "task_vision_gripper.h"
+
+/* ==================== 私有类型 ==================== */
+
+typedef struct {
+    const char *name;
+    uint32_t  (*run)(void);     // 返回0=成功
+} HostMission_t;
+
+/* ==================== 任务适配 ==================== */
+
+static uint32_t mission_pickup(void)
+{
+    return (uint32_t)Task_Material_Pickup();
+}
+
+static uint32_t mission_sorting(void)
+{
+    return Task_Auto_Sorting() ? 0U : 1U;
+}
+
+/**
+ * @brief 到位窗口校核: 长行程运动不得在加速阶段(约MOTOR_INPOS_POLL_MS)就判为完成
+ * @return 0=通过, 1=过早完成或未完成
+ */
+static uint32_t mission_inpos(void)
+{
+    const float dist_mm = 600.0f;
+    MotorMovePlan_t plan;
+    uint32_t t0, done, elapsed;
+
+    Motor_Plan_Move(dist_mm, &plan);
+    if (!Motor_Move_XYTheta(dist_mm, 0.0f, 0.0f, 0)) {
+        return 1;
+    }
+    t0 = HAL_GetTick();
+    done = Motor_Wait_InPosition(MOTOR_MASK_WHEELS, (uint32_t)(plan.t_pred_s * 2000.0f) + 500U);
+    elapsed = HAL_GetTick() - t0;
+    if (done != MOTOR_MASK_WHEELS || elapsed < (uint32_t)(plan.t_pred_s * 900.0f)) {
+        printf("inpos: done=0x%02lx after %lums, planned %.0fms\n",
+               (unsigned long)done, (unsigned long)elapsed, plan.t_pred_s * 1000.0f);
+        return 1;
+    }
+    Motor_Wait_All(MOTOR_MASK_WHEELS, 1000);
+    return 0;
+}
+
+static const HostMission_t s_missions[] = {
+    { "pickup",  mission_pickup  },
+    { "sorting", mission_sorting },
+    { "inpos",   mission_inpos   },
+};
+
+/* ==================== 场地布置 ==================== */
+
+#define HOST_BLOCK_OFFSET_MM    15      // 物块相对名义位置的最大摆放偏差 (mm)
+
+/**
+ * @brief 车体回到原点, 三色物块在名义位置上叠加偏差后重新摆放
+ * @note 偏差由迭代序号决定, 同一迭代次数的运行结果可复现
+ */
+static void field_setup(uint32_t iteration)
+{
+    static const VisualObject_t objs[3] = { VIS_OBJ_RED, VIS_OBJ_GREEN, VIS_OBJ_BLUE };
+    uint32_t seed = iteration * 2654435761U + 1U;
+    uint8_t k;
+
+    Field_Sim_Reset_Pose();
+    Field_Sim_Clear_Objects();
+    for (k = 0; k < 3; k++) {
+        int ox, oy;
+
+        seed = seed * 1103515245U + 12345U;
+        ox = (int)((seed >> 16) % (2U * HOST_BLOCK_OFFSET_MM + 1U)) - HOST_BLOCK_OFFSET_MM;
+        seed = seed * 1103515245U + 12345U;
+        oy = (int)((seed >> 16) % (2U * HOST_BLOCK_OFFSET_MM + 1U)) - HOST_BLOCK_OFFSET_MM;
+        Field_Sim_Set_Object(objs[k], FIELD_MATERIAL_X_MM + (float)ox,
+                             (float)((int)k - 1) * FIELD_BLOCK_PITCH_MM + (float)oy);
+    }
+}
+
+/* ==================== 模拟驱动器 ==================== */
+
+/**
+ * @brief 按emm_bus路由表把模拟驱动器挂到各自的串口上
+ */
+static void sim_attach_routed(void)
+{
+    static const uint8_t addrs[] = {
+        MOTOR_WHEEL_ADDR_FL, MOTOR_WHEEL_ADDR_FR, MOTOR_WHEEL_ADDR_RL, MOTOR_WHEEL_ADDR_RR,
+        GRIPPER_LIFT_MOTOR_ADDR
+    };
+    size_t k;
+
+    Emm_Sim_Init(Emm_Bus_Route(addrs[0]), &addrs[0], 1);
+    for (k = 1; k < sizeof(addrs); k++) {
+        Emm_Sim_Attach(Emm_Bus_Route(addrs[k]), &addrs[k], 1);
+    }
+}
+
+static void print_uart(const char *name, const UART_HandleTypeDef *huart)
+{
+    printf("%s: tx_bytes=%llu rx_bytes=%llu tx_busy_ms=%.3f caller_blocked_ms=%.3f\n", name,
+           (unsigned long long)huart->host.stat_tx_bytes,
+           (unsigned long long)huart->host.stat_rx_bytes,
+           huart->host.stat_tx_busy_us / 1000.0,
+           huart->host.stat_tx_block_us / 1000.0);
+}
+
+/* ==================== 主函数 ==================== */
+
+int main(int argc, char **argv)
+{
+    const HostMission_t *mission = &s_missions[0];
+    uint32_t iterations = 1;
+    uint32_t i, failures = 0;
+    uint64_t t_min = UINT64_MAX, t_max = 0, t_sum = 0;
+    size_t m;
+
+    if (argc > 1) {
+        mission = NULL;
+        for (m = 0; m < sizeof(s_missions) / sizeof(s_missions[0]); m++) {
+            if (strcmp(argv[1], s_missions[m].name) == 0) {
+                mission = &s_missions[m];
+            }
+        }
+        if (mission == NULL) {
+            fprintf(stderr, "usage: %s [pickup|sorting|inpos] [iterations]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (argc > 2) {
+        iterations = (uint32_t)strtoul(argv[2], NULL, 10);
+    }
+    if (iterations == 0) {
+        fprintf(stderr, "iterations must be at least 1\n");
+        return 2;
+    }
+
+    Host_Board_Init();
+    sim_attach_routed();
+    Field_Sim_Init();
+
+    for (i = 0; i < iterations; i++) {
+        uint64_t t0;
+
+        field_setup(i);
+        t0 = Host_Clock_Now_us();
+        if (mission->run() != 0U) {
+            failures++;
+        }
+        uint64_t dt = Host_Clock_Now_us() - t0;
+        t_sum += dt;
+        if (dt < t_min) t_min = dt;
+        if (dt > t_max) t_max = dt;
+    }
+
+    printf("mission=%s iterations=%u failures=%u\n", mission->name, iterations, failures);
+    printf("virtual time ms: min=%.3f avg=%.3f max=%.3f\n",
+           t_min / 1000.0, (double)t_sum / iterations / 1000.0, t_max / 1000.0);
+    print_uart("usart1", &huart1);
+    print_uart("usart2", &huart2);
+    print_uart("usart3", &huart3);
+    printf("vision frames sent=%u\n", Field_Sim_Frames_Sent());
+    Emm_Sim_Print_Report(stdout, t_sum);
+    return failures ? 1 : 0;
+}
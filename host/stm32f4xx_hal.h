@@ -0,0 +1,362 @@
+/**
+  ******************************************************************************
+  * @file    stm32f4xx_hal.h (host)
+  * @brief   主机端HAL替身 - 在Linux上编译运行任务逻辑
+  * @details 仅提供固件实际用到的UART/I2C/TIM/DMA/GPIO/时基接口,
+  *          所有时间均基于虚拟时钟(微秒), 与真实墙钟无关:
+  *          - HAL_Delay()   推进虚拟时钟
+  *          - HAL_GetTick() 返回虚拟毫秒, 每次调用计入少量轮询开销
+  *          - 阻塞发送按波特率计算线上时间并推进时钟
+  *          - DMA/IT收发在虚拟时间到达时触发对应HAL回调
+  *          编译时将 host/ 放在包含路径最前面, 即可替换真实HAL:
+  *            gcc -DHOST_BUILD -Ihost -I. host/ *.c motor.c gripper.c ...
+  ******************************************************************************
+  */
+
+#ifndef __STM32F4XX_HAL_H
+#define __STM32F4XX_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef HOST_BUILD
+#define HOST_BUILD
+#endif
+
+/* ==================== 编译器/内核相关 ==================== */
+
+#define __IO            volatile
+#define __weak          __attribute__((weak))
+#define __NOP()         do { } while (0)
+#define __DSB()         do { } while (0)
+#define __DMB()         do { } while (0)
+#define __disable_irq() do { } while (0)
+#define __enable_irq()  do { } while (0)
+
+#define UNUSED(x)       ((void)(x))
+
+// 中断号只用于NVIC配置, 主机端中断由事件循环直接调用回调
+typedef enum {
+    TIM1_UP_TIM10_IRQn = 25
+} IRQn_Type;
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY   0xFFFFFFFFU
+
+/* ==================== 虚拟时钟 ==================== */
+
+#define HOST_GETTICK_COST_US    10U     // 每次HAL_GetTick()计入的轮询开销 (us)
+#define HOST_MAX_STEP_US        100U    // 推进时钟的最大步长, 决定事件分辨率 (us)
+
+typedef void (*Host_TickHook_t)(uint64_t now_us);
+
+void     Host_Clock_Reset(void);
+uint64_t Host_Clock_Now_us(void);
+void     Host_Clock_Advance_us(uint64_t us);
+uint8_t  Host_Register_Tick_Hook(Host_TickHook_t hook);
+
+void     HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetTick(void);
+void     HAL_IncTick(void);
+
+/* ==================== GPIO ==================== */
+
+typedef struct {
+    uint32_t ODR;
+    uint32_t IDR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef Host_GPIOA, Host_GPIOB, Host_GPIOC, Host_GPIOD, Host_GPIOE;
+#define GPIOA   (&Host_GPIOA)
+#define GPIOB   (&Host_GPIOB)
+#define GPIOC   (&Host_GPIOC)
+#define GPIOD   (&Host_GPIOD)
+#define GPIOE   (&Host_GPIOE)
+
+#define GPIO_PIN_0      ((uint16_t)0x0001)
+#define GPIO_PIN_1      ((uint16_t)0x0002)
+#define GPIO_PIN_2      ((uint16_t)0x0004)
+#define GPIO_PIN_3      ((uint16_t)0x0008)
+#define GPIO_PIN_4      ((uint16_t)0x0010)
+#define GPIO_PIN_5      ((uint16_t)0x0020)
+#define GPIO_PIN_6      ((uint16_t)0x0040)
+#define GPIO_PIN_7      ((uint16_t)0x0080)
+#define GPIO_PIN_8      ((uint16_t)0x0100)
+#define GPIO_PIN_9      ((uint16_t)0x0200)
+#define GPIO_PIN_10     ((uint16_t)0x0400)
+#define GPIO_PIN_11     ((uint16_t)0x0800)
+#define GPIO_PIN_12     ((uint16_t)0x1000)
+#define GPIO_PIN_13     ((uint16_t)0x2000)
+#define GPIO_PIN_14     ((uint16_t)0x4000)
+#define GPIO_PIN_15     ((uint16_t)0x8000)
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+void          HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void          HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/* ==================== DMA ==================== */
+
+#define DMA_NORMAL      0x00000000U
+#define DMA_CIRCULAR    0x00000100U
+
+typedef struct {
+    uint32_t Mode;
+} DMA_InitTypeDef;
+
+typedef struct {
+    void           *Instance;
+    DMA_InitTypeDef Init;
+    __IO uint32_t   host_ndtr;      // 模拟NDTR: 剩余传输数
+} DMA_HandleTypeDef;
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__)   ((__HANDLE__)->host_ndtr)
+
+/* ==================== UART ==================== */
+
+typedef struct {
+    uint32_t id;
+} USART_TypeDef;
+
+extern USART_TypeDef Host_USART1, Host_USART2, Host_USART3;
+#define USART1  (&Host_USART1)
+#define USART2  (&Host_USART2)
+#define USART3  (&Host_USART3)
+
+typedef struct {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef enum {
+    HAL_UART_STATE_RESET   = 0x00U,
+    HAL_UART_STATE_READY   = 0x20U,
+    HAL_UART_STATE_BUSY_TX = 0x21U,
+    HAL_UART_STATE_BUSY_RX = 0x22U
+} HAL_UART_StateTypeDef;
+
+#define HOST_UART_RX_FIFO   1024U
+
+/** 线上字节发送完成时回调(帧级), 用于挂接外设模拟器 */
+typedef void (*Host_UART_TxSink_t)(void *ctx, const uint8_t *data, uint16_t len,
+                                   uint64_t t_start_us, uint64_t t_end_us);
+/** 接收字节回调(模拟USARTx_IRQHandler中逐字节读取DR) */
+typedef void (*Host_UART_RxHook_t)(void *ctx, uint8_t byte);
+/** 接收线路空闲回调(模拟IDLE中断) */
+typedef void (*Host_UART_IdleHook_t)(void *ctx);
+
+typedef struct {
+    /* 发送 */
+    uint64_t tx_busy_until_us;
+    uint8_t  tx_dma_pending;
+    uint64_t tx_dma_done_us;
+    Host_UART_TxSink_t tx_sink;
+    void    *tx_ctx;
+
+    /* 接收: 线上字节FIFO, 每个字节带到达时间 */
+    uint8_t  rx_fifo[HOST_UART_RX_FIFO];
+    uint64_t rx_time[HOST_UART_RX_FIFO];
+    uint16_t rx_head;
+    uint16_t rx_tail;
+    uint64_t rx_line_free_us;
+    uint64_t rx_last_byte_us;
+    uint8_t  rx_idle_pending;
+
+    uint8_t  rx_mode;               // 0=未启动 1=IT 2=DMA 3=DMA+IDLE
+    uint8_t *rx_buf;
+    uint16_t rx_size;
+    uint16_t rx_pos;
+    Host_UART_RxHook_t   rx_hook;
+    Host_UART_IdleHook_t idle_hook;
+    void    *rx_ctx;
+
+    /* 统计 */
+    uint64_t stat_tx_bytes;
+    uint64_t stat_rx_bytes;
+    uint64_t stat_tx_busy_us;
+    uint64_t stat_tx_block_us;      // 阻塞发送占用调用者的时间
+} Host_UartState_t;
+
+typedef struct __UART_HandleTypeDef {
+    USART_TypeDef         *Instance;
+    UART_InitTypeDef       Init;
+    DMA_HandleTypeDef     *hdmatx;
+    DMA_HandleTypeDef     *hdmarx;
+    __IO HAL_UART_StateTypeDef gState;
+    __IO HAL_UART_StateTypeDef RxState;
+    Host_UartState_t       host;
+} UART_HandleTypeDef;
+
+#define UART_IT_IDLE    0x0010U
+#define UART_IT_RXNE    0x0020U
+#define UART_IT_TC      0x0040U
+#define UART_FLAG_IDLE  0x0010U
+#define UART_FLAG_RXNE  0x0020U
+
+#define __HAL_UART_ENABLE_IT(__HANDLE__, __IT__)    ((void)(__HANDLE__), (void)(__IT__))
+#define __HAL_UART_DISABLE_IT(__HANDLE__, __IT__)   ((void)(__HANDLE__), (void)(__IT__))
+#define __HAL_UART_GET_FLAG(__HANDLE__, __FLAG__)   ((void)(__HANDLE__), (void)(__FLAG__), 0U)
+#define __HAL_UART_CLEAR_IDLEFLAG(__HANDLE__)       ((void)(__HANDLE__))
+#define __HAL_DMA_DISABLE_IT(__HANDLE__, __IT__)    ((void)(__HANDLE__), (void)(__IT__))
+#define DMA_IT_HT       0x00000008U
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart);
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+
+/* 主机端UART扩展: 供模拟器/测试程序使用 */
+uint32_t Host_UART_Wire_Time_us(const UART_HandleTypeDef *huart, uint16_t len);
+void     Host_UART_Set_Tx_Sink(UART_HandleTypeDef *huart, Host_UART_TxSink_t sink, void *ctx);
+void     Host_UART_Set_Rx_Hooks(UART_HandleTypeDef *huart, Host_UART_RxHook_t rx,
+                                Host_UART_IdleHook_t idle, void *ctx);
+void     Host_UART_Garble_Rx(UART_HandleTypeDef *huart, uint64_t after_us);
+uint16_t Host_UART_Feed_Rx(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t len,
+                           uint64_t not_before_us);
+void     Host_UART_Register(UART_HandleTypeDef *huart);
+
+/* ==================== I2C ==================== */
+
+typedef struct {
+    uint32_t id;
+} I2C_TypeDef;
+
+typedef struct {
+    uint32_t ClockSpeed;
+} I2C_InitTypeDef;
+
+typedef struct {
+    I2C_TypeDef     *Instance;
+    I2C_InitTypeDef  Init;
+} I2C_HandleTypeDef;
+
+#define I2C_MEMADD_SIZE_8BIT    0x00000001U
+#define I2C_MEMADD_SIZE_16BIT   0x00000010U
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+/* ==================== TIM ==================== */
+
+typedef struct {
+    uint32_t id;
+} TIM_TypeDef;
+
+extern TIM_TypeDef Host_TIM1;
+#define TIM1    (&Host_TIM1)
+
+typedef struct {
+    uint32_t Prescaler;
+    uint32_t Period;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+    TIM_TypeDef          *Instance;
+    TIM_Base_InitTypeDef  Init;
+    uint32_t              host_ccr[4];
+    uint32_t              host_period_us;   // 更新事件周期, 0=不产生更新中断
+    uint64_t              host_next_update_us;
+    uint8_t               host_it_enabled;
+} TIM_HandleTypeDef;
+
+#define TIM_CHANNEL_1   0x00000000U
+#define TIM_CHANNEL_2   0x00000004U
+#define TIM_CHANNEL_3   0x00000008U
+#define TIM_CHANNEL_4   0x0000000CU
+
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__) \
+    ((__HANDLE__)->host_ccr[(__CHANNEL__) >> 2U] = (__COMPARE__))
+#define __HAL_TIM_GET_COMPARE(__HANDLE__, __CHANNEL__) \
+    ((__HANDLE__)->host_ccr[(__CHANNEL__) >> 2U])
+#define __HAL_TIM_GET_AUTORELOAD(__HANDLE__)    ((__HANDLE__)->Init.Period)
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
+void Host_TIM_Register(TIM_HandleTypeDef *htim, uint32_t period_us);
+
+/* ==================== PWR / 备份SRAM ==================== */
+
+extern uint8_t Host_BKPSRAM[4096];
+#define BKPSRAM_BASE                    ((uintptr_t)Host_BKPSRAM)
+#define __HAL_RCC_PWR_CLK_ENABLE()      do { } while (0)
+#define __HAL_RCC_BKPSRAM_CLK_ENABLE()  do { } while (0)
+
+void HAL_PWR_EnableBkUpAccess(void);
+HAL_StatusTypeDef HAL_PWREx_EnableBkUpReg(void);
+
+/* ==================== FLASH ==================== */
+
+#define HOST_FLASH_SIZE                 0x100000U   // 1MB, 扇区布局与STM32F407相同
+extern uint8_t Host_FLASH[HOST_FLASH_SIZE];
+#define FLASH_BASE                      ((uintptr_t)Host_FLASH)
+extern uint16_t Host_FLASHSIZE_KB;
+#define FLASHSIZE_BASE                  ((uintptr_t)&Host_FLASHSIZE_KB)     // 芯片Flash容量(KB)
+
+#define FLASH_TYPEERASE_SECTORS         0x00000000U
+#define FLASH_VOLTAGE_RANGE_3           0x00000002U
+#define FLASH_TYPEPROGRAM_WORD          0x00000002U
+#define FLASH_BANK_1                    1U
+#define FLASH_SECTOR_11                 11U
+
+typedef struct {
+    uint32_t TypeErase;
+    uint32_t Banks;
+    uint32_t Sector;
+    uint32_t NbSectors;
+    uint32_t VoltageRange;
+} FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F4XX_HAL_H */
@@ -0,0 +1,122 @@
+/**
+  ******************************************************************************
+  * @file    Emm_V5.c (host stub)
+  * @brief   主机端替身 - 快照中缺少上游Emm_V5.c时使用
+  * @details 按Emm_V5.0串口协议编码命令帧, 与上游驱动相同经usart_SendCmd()发送,
+  *          由host_board.c路由到emm_bus发送队列; 上游Emm_V5.c存在时
+  *          host/Makefile自动改用上游文件
+  ******************************************************************************
+  */
+
+#include "Emm_V5.h"
+#include "emm_bus.h"
+
+void usart_SendCmd(__IO uint8_t *cmd, uint8_t len);
+
+/* ==================== 公开函数 ==================== */
+
+void Emm_V5_Reset_CurPos_To_Zero(uint8_t addr)
+{
+    uint8_t cmd[4] = { addr, 0x0A, 0x6D, 0x6B };
+
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_Reset_Clog_Pro(uint8_t addr)
+{
+    uint8_t cmd[4] = { addr, 0x0E, 0x52, 0x6B };
+
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_Read_Sys_Params(uint8_t addr, SysParams_t s)
+{
+    uint8_t cmd[EMM_READ_FRAME_MAX];
+    uint8_t len = Emm_Bus_Build_Read(cmd, addr, s);
+
+    if (len > 0) {
+        usart_SendCmd(cmd, len);
+    }
+}
+
+void Emm_V5_Modify_Ctrl_Mode(uint8_t addr, bool svF, uint8_t ctrl_mode)
+{
+    uint8_t cmd[6] = { addr, 0x46, 0x69, (uint8_t)svF, ctrl_mode, 0x6B };
+
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_En_Control(uint8_t addr, bool state, bool snF)
+{
+    uint8_t cmd[6] = { addr, 0xF3, 0xAB, (uint8_t)state, (uint8_t)snF, 0x6B };
+
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_Vel_Control(uint8_t addr, uint8_t dir, uint16_t vel, uint8_t acc, bool snF)
+{
+    uint8_t cmd[EMM_VEL_FRAME_LEN];
+
+    Emm_Bus_Build_Vel(cmd, addr, dir, vel, acc, snF);
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_Pos_Control(uint8_t addr, uint8_t dir, uint16_t vel, uint8_t acc, uint32_t clk, bool raF, bool snF)
+{
+    uint8_t cmd[EMM_POS_FRAME_LEN];
+
+    Emm_Bus_Build_Pos(cmd, addr, dir, vel, acc, clk, raF, snF);
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_Stop_Now(uint8_t addr, bool snF)
+{
+    uint8_t cmd[5] = { addr, 0xFE, 0x98, (uint8_t)snF, 0x6B };
+
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_Synchronous_motion(uint8_t addr)
+{
+    uint8_t cmd[EMM_SYNC_FRAME_LEN];
+
+    Emm_Bus_Build_Sync(cmd, addr);
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_Origin_Set_O(uint8_t addr, bool svF)
+{
+    uint8_t cmd[5] = { addr, 0x93, 0x88, (uint8_t)svF, 0x6B };
+
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_Origin_Modify_Params(uint8_t addr, bool svF, uint8_t o_mode, uint8_t o_dir, uint16_t o_vel,
+                                 uint32_t o_tm, uint16_t sl_vel, uint16_t sl_ma, uint16_t sl_ms, bool potF)
+{
+    uint8_t cmd[20] = {
+        addr, 0x4C, 0xAE, (uint8_t)svF, o_mode, o_dir,
+        (uint8_t)(o_vel >> 8), (uint8_t)o_vel,
+        (uint8_t)(o_tm >> 24), (uint8_t)(o_tm >> 16), (uint8_t)(o_tm >> 8), (uint8_t)o_tm,
+        (uint8_t)(sl_vel >> 8), (uint8_t)sl_vel,
+        (uint8_t)(sl_ma >> 8), (uint8_t)sl_ma,
+        (uint8_t)(sl_ms >> 8), (uint8_t)sl_ms,
+        (uint8_t)potF, 0x6B
+    };
+
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_Origin_Trigger_Return(uint8_t addr, uint8_t o_mode, bool snF)
+{
+    uint8_t cmd[5] = { addr, 0x9A, o_mode, (uint8_t)snF, 0x6B };
+
+    usart_SendCmd(cmd, sizeof(cmd));
+}
+
+void Emm_V5_Origin_Interrupt(uint8_t addr)
+{
+    uint8_t cmd[4] = { addr, 0x9C, 0x48, 0x6B };
+
+    usart_SendCmd(cmd, sizeof(cmd));
+}
@@ -0,0 +1,60 @@
+/**
+  ******************************************************************************
+  * @file    gripper.c (host stub)
+  * @brief   主机端替身 - 快照中缺少上游gripper.c时使用
+  * @details 上游gripper.c的公开函数在此转调新模块, 原型与gripper.h一致:
+  *          Gripper_Lift/Gripper_Get_Height -> gripper_lift.c,
+  *          云台/爪子 -> servo_ramp.c, Gripper_PickAndPlace -> gripper_seq.c;
+  *          上游gripper.c存在时host/Makefile自动改用上游文件
+  ******************************************************************************
+  */
+
+#include "gripper.h"
+#include "servo.h"
+
+/* ==================== 私有变量 ==================== */
+
+static uint8_t s_pickup_counter = 0;
+
+/* ==================== 公开函数 ==================== */
+
+void Gripper_Lift(float height_mm)
+{
+    Gripper_Lift_Wait(height_mm);
+}
+
+float Gripper_Get_Height(void)
+{
+    return Gripper_Lift_Get_Height();
+}
+
+void Gripper_Pan_Rotate(float angle_deg)
+{
+    Servo_Move(SERVO_PAN, angle_deg, 0.0f);
+}
+
+void Gripper_Claw_Open(void)
+{
+    Servo_Move(SERVO_CLAW, GRIPPER_CLAW_MAX_ANGLE, 0.0f);
+}
+
+void Gripper_Claw_Close(void)
+{
+    Servo_Move(SERVO_CLAW, GRIPPER_CLAW_MIN_ANGLE, 0.0f);
+}
+
+void Gripper_PickAndPlace(int plate_number)
+{
+    s_pickup_counter++;
+    Gripper_Seq_PickAndPlace(plate_number, s_pickup_counter < 3);   // 第3次不回原位
+}
+
+void Gripper_Reset_PickupCounter(void)
+{
+    s_pickup_counter = 0;
+}
+
+uint8_t Gripper_Get_PickupCounter(void)
+{
+    return s_pickup_counter;
+}
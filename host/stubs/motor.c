@@ -0,0 +1,126 @@
+/**
+  ******************************************************************************
+  * @file    motor.c (host stub)
+  * @brief   主机端替身 - 快照中缺少上游motor.c时使用
+  * @details 上游motor.c中的单向运动接口在此以Motor_Move_XYTheta + Motor_Wait_All实现,
+  *          行为与上游"下发后阻塞到位"一致, 参数符号按motor.h约定;
+  *          上游motor.c存在时host/Makefile自动改用上游文件
+  ******************************************************************************
+  */
+
+#include "motor.h"
+#include "Emm_V5.h"
+#include "inv_mpu.h"
+#include "stm32f4xx_hal.h"
+
+#include <math.h>
+
+/* ==================== 私有变量 ==================== */
+
+static const uint16_t s_profile_rpm[3] = { 30, 50, 80 };
+static uint16_t s_default_rpm = 50;
+
+#define STUB_MOVE_TIMEOUT_MS    10000   // 单向运动等待到位超时
+
+/* ==================== 私有函数 ==================== */
+
+static void move_and_wait(float dx_mm, float dy_mm, float dth_deg, uint16_t speed_rpm)
+{
+    if (dx_mm == 0.0f && dy_mm == 0.0f && dth_deg == 0.0f) {
+        return;
+    }
+    if (speed_rpm == 0) {
+        speed_rpm = s_default_rpm;
+    }
+    if (Motor_Move_XYTheta(dx_mm, dy_mm, dth_deg, speed_rpm)) {
+        Motor_Wait_All(MOTOR_MASK_WHEELS, STUB_MOVE_TIMEOUT_MS);
+    }
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Motor_Init(void)
+{
+    uint8_t addr;
+
+    for (addr = MOTOR_WHEEL_ADDR_FL; addr <= MOTOR_WHEEL_ADDR_RR; addr++) {
+        Emm_V5_En_Control(addr, true, false);
+    }
+}
+
+void Motor_Move_Forward(float distance_mm, uint16_t speed_rpm)
+{
+    move_and_wait(distance_mm, 0.0f, 0.0f, speed_rpm);
+}
+
+void Motor_Move_Lateral(float distance_mm, uint16_t speed_rpm)
+{
+    move_and_wait(0.0f, distance_mm, 0.0f, speed_rpm);
+}
+
+void Motor_Move_Rotate(float angle_deg, uint16_t speed_rpm)
+{
+    move_and_wait(0.0f, 0.0f, angle_deg, speed_rpm);
+}
+
+void Motor_Stop_All(void)
+{
+    uint8_t addr;
+
+    for (addr = MOTOR_WHEEL_ADDR_FL; addr <= MOTOR_WHEEL_ADDR_RR; addr++) {
+        Emm_V5_Stop_Now(addr, false);
+    }
+}
+
+void Motor_Emergency_Stop(void)
+{
+    Motor_Stop_All();
+}
+
+void Motor_Set_Speed_Profile(uint8_t profile)
+{
+    if (profile < 3) {
+        s_default_rpm = s_profile_rpm[profile];
+    }
+}
+
+float Motor_Get_Rotation_From_Yaw(float yaw_start_deg, float yaw_now_deg)
+{
+    float d = yaw_now_deg - yaw_start_deg;
+
+    while (d > 180.0f)   d -= 360.0f;
+    while (d <= -180.0f) d += 360.0f;
+    return d;
+}
+
+void Motor_Move_Forward_WithYawHold(float distance_mm, float target_yaw_deg,
+                                    float tolerance_deg, uint16_t speed_rpm)
+{
+    Motor_Traj_Forward_YawHold(distance_mm, target_yaw_deg, tolerance_deg, speed_rpm);
+}
+
+void Motor_Move_Lateral_WithYawHold(float distance_mm, float target_yaw_deg,
+                                    float tolerance_deg, uint16_t speed_rpm, float segment)
+{
+    (void)segment;
+    Motor_Traj_Lateral_YawHold(-distance_mm, target_yaw_deg, tolerance_deg, speed_rpm);   // 本函数正值左移
+}
+
+uint8_t Motor_Rotate_90_DMP(uint8_t clockwise, uint16_t speed_rpm)
+{
+    return Motor_Rotate_DMP_Predict(clockwise ? -90.0f : 90.0f, 2.0f, speed_rpm);
+}
+
+uint8_t Motor_Correct_Yaw(float target_yaw_deg, float tolerance_deg, uint16_t speed_rpm)
+{
+    float pitch, roll, yaw, err;
+
+    if (mpu_dmp_get_data(&pitch, &roll, &yaw) != 0) {
+        return 1;
+    }
+    err = Motor_Get_Rotation_From_Yaw(yaw, target_yaw_deg);
+    if (fabsf(err) <= tolerance_deg) {
+        return 0;
+    }
+    return Motor_Rotate_DMP_Predict(err, tolerance_deg, speed_rpm) == 1 ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+/**
+  ******************************************************************************
+  * @file    task.c (host stub)
+  * @brief   主机端替身 - 快照中缺少上游task.c时使用
+  * @details Task_Material_Pickup按名义场地布置(field_sim.h)运行同样的动作组合:
+  *          驶出启停区 -> 依次横移到蓝/绿/红物块前, 视觉伺服对位后抓取放入物料盘 -> 转向下一区域;
+  *          上游task.c存在时host/Makefile自动改用上游文件
+  ******************************************************************************
+  */
+
+#include "task.h"
+#include "motor.h"
+#include "gripper.h"
+#include "visual_servo.h"
+#include "field_sim.h"
+
+/* ==================== 私有函数 ==================== */
+
+/**
+ * @brief 从当前横向位置移到物块前, 对位并抓取
+ * @param lateral_mm 输入/输出: 当前横向位置 (右为正)
+ */
+static TaskStatus_t pick_block(ColorTarget_t color, int plate, float *lateral_mm)
+{
+    float y = (float)((int)color - (int)COLOR_GREEN) * FIELD_BLOCK_PITCH_MM;
+
+    if (!Motor_Move_XYTheta(0.0f, y - *lateral_mm, 0.0f, 0)) {
+        return TASK_FAILED;
+    }
+    if (Motor_Wait_All(MOTOR_MASK_WHEELS, 3000) != MOTOR_MASK_WHEELS) {
+        return TASK_TIMEOUT;
+    }
+    *lateral_mm = y;
+    if (Visual_Servo_Align(TARGET_MATERIAL_BLOCK, color) != VSERVO_OK) {
+        return TASK_VISION_ERROR;
+    }
+    return Gripper_Seq_PickAndPlace(plate, true) == 0 ? TASK_SUCCESS : TASK_FAILED;
+}
+
+/* ==================== 公开函数 ==================== */
+
+TaskStatus_t Task_Material_Pickup(void)
+{
+    static const ColorTarget_t order[3] = { COLOR_BLUE, COLOR_GREEN, COLOR_RED };
+    float lateral = 0.0f;
+    TaskStatus_t st;
+    uint8_t i;
+
+    if (!Motor_Move_XYTheta(FIELD_MATERIAL_X_MM, 0.0f, 0.0f, 0)) {
+        return TASK_FAILED;
+    }
+    if (Motor_Wait_All(MOTOR_MASK_WHEELS, 5000) != MOTOR_MASK_WHEELS) {
+        return TASK_TIMEOUT;
+    }
+    for (i = 0; i < 3; i++) {
+        st = pick_block(order[i], (int)order[i], &lateral);
+        if (st != TASK_SUCCESS) {
+            return st;
+        }
+    }
+    return Motor_Rotate_90_DMP(1, 0) == 0 ? TASK_SUCCESS : TASK_FAILED;
+}
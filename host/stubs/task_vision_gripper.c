@@ -0,0 +1,51 @@
+/**
+  ******************************************************************************
+  * @file    task_vision_gripper.c (host stub)
+  * @brief   主机端替身 - 快照中缺少上游task_vision_gripper.c时使用
+  * @details Task_Auto_Sorting在物料台前(名义场地布置, field_sim.h)按红→绿→蓝顺序
+  *          横移、视觉伺服对位并抓取放入对应物料盘, 结束后回到起点;
+  *          上游task_vision_gripper.c存在时host/Makefile自动改用上游文件
+  ******************************************************************************
+  */
+
+#include "task_vision_gripper.h"
+#include "motor.h"
+#include "gripper.h"
+#include "visual_servo.h"
+#include "field_sim.h"
+
+/* ==================== 私有函数 ==================== */
+
+static bool move_wait(float dx_mm, float dy_mm)
+{
+    return Motor_Move_XYTheta(dx_mm, dy_mm, 0.0f, 0) &&
+           Motor_Wait_All(MOTOR_MASK_WHEELS, 5000) == MOTOR_MASK_WHEELS;
+}
+
+/* ==================== 公开函数 ==================== */
+
+bool Task_Auto_Sorting(void)
+{
+    static const ColorTarget_t order[3] = { COLOR_RED, COLOR_GREEN, COLOR_BLUE };
+    float lateral = 0.0f;
+    uint8_t i;
+
+    if (!move_wait(FIELD_MATERIAL_X_MM, 0.0f)) {
+        return false;
+    }
+    for (i = 0; i < 3; i++) {
+        float y = (float)((int)order[i] - (int)COLOR_GREEN) * FIELD_BLOCK_PITCH_MM;
+
+        if (!move_wait(0.0f, y - lateral)) {
+            return false;
+        }
+        lateral = y;
+        if (Visual_Servo_Align(TARGET_MATERIAL_BLOCK, order[i]) != VSERVO_OK) {
+            return false;
+        }
+        if (Gripper_Seq_PickAndPlace((int)order[i], true) != 0) {
+            return false;
+        }
+    }
+    return move_wait(-FIELD_MATERIAL_X_MM, -lateral);
+}
@@ -0,0 +1,34 @@
+/**
+  ******************************************************************************
+  * @file    visual_comm.c (host stub)
+  * @brief   主机端替身 - 快照中缺少上游visual_comm.c时使用
+  * @details 仅提供visual_stream.c写入的VIS_RX等全局数据; USART3接收默认由visual_stream占用,
+  *          旧版请求-应答接收在主机端不启用, 接收回调为空. 上游visual_comm.c存在时host/Makefile自动改用上游文件
+  ******************************************************************************
+  */
+
+#include "visual_comm.h"
+#include <string.h>
+
+/* ==================== 全局变量 ==================== */
+
+VisualRxData_t VIS_RX;
+uint8_t color_task[6];
+uint8_t visual_rx_complete_flag;
+
+/* ==================== 公开函数 ==================== */
+
+void Visual_Data_Init(void)
+{
+    memset(&VIS_RX, 0, sizeof(VIS_RX));
+    memset(color_task, 0, sizeof(color_task));
+    visual_rx_complete_flag = 0;
+}
+
+void Visual_UART_RxCallback(void)
+{
+}
+
+void Visual_UART_Start_Receive(void)
+{
+}
@@ -4,6 +4,143 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* ==================== 硬件配置参数 ==================== */
+
+// 四轮驱动器地址 (Emm_V5)
+#define MOTOR_WHEEL_ADDR_FL         1       // 左前轮
+#define MOTOR_WHEEL_ADDR_FR         2       // 右前轮
+#define MOTOR_WHEEL_ADDR_RL         3       // 左后轮
+#define MOTOR_WHEEL_ADDR_RR         4       // 右后轮
+#define MOTOR_WHEEL_COUNT           4
+
+// 电机位掩码 (用于到位/堵转等待)
+#define MOTOR_MASK(addr)            (1UL << (addr))
+#define MOTOR_MASK_WHEELS           (MOTOR_MASK(MOTOR_WHEEL_ADDR_FL) | MOTOR_MASK(MOTOR_WHEEL_ADDR_FR) | \
+                                     MOTOR_MASK(MOTOR_WHEEL_ADDR_RL) | MOTOR_MASK(MOTOR_WHEEL_ADDR_RR))
+
+// 底盘几何 (麦克纳姆轮, X型安装)
+// !! 未核实的占位值: 本工程快照中没有motor.c, 以下数值不是从其单向运动参数取得的,
+// !! 须按实车测量(或motor.c中的实际参数)替换, 核对后把MOTOR_GEOMETRY_VERIFIED改为1;
+// !! 未核对时固件编译报错, 主机端(HOST_BUILD)以同一组数值作为仿真车体参数
+#define MOTOR_GEOMETRY_VERIFIED     0       // 0=占位值, 固件编译时报错
+#define MOTOR_WHEEL_DIAMETER_MM     75.0f   // 车轮直径 (mm), 占位
+#define MOTOR_PULSES_PER_REV        3200    // 每圈脉冲数 (16细分), 占位, 须与驱动器细分设置一致
+#define MOTOR_CHASSIS_HALF_L_MM     95.0f   // 轮距一半: 前后轮中心距/2 (mm), 占位
+#define MOTOR_CHASSIS_HALF_W_MM     100.0f  // 轮距一半: 左右轮中心距/2 (mm), 占位
+
+// 车轮安装方向: 车体前进时该轮脉冲的符号 (右侧电机镜像安装), 占位, 须逐轮点动核对
+#define MOTOR_WHEEL_SIGN_FL         (+1)
+#define MOTOR_WHEEL_SIGN_FR         (-1)
+#define MOTOR_WHEEL_SIGN_RL         (+1)
+#define MOTOR_WHEEL_SIGN_RR         (-1)
+
+#if !MOTOR_GEOMETRY_VERIFIED && !defined(HOST_BUILD)
+#error "motor.h: chassis geometry and wheel signs are unverified placeholders - measure them, then set MOTOR_GEOMETRY_VERIFIED to 1"
+#endif
+
+// 合成运动默认参数
+#define MOTOR_XY_DEFAULT_RPM        50      // 最快车轮的速度 (RPM)
+#define MOTOR_XY_DEFAULT_ACC        200     // 最快车轮的加速度档位
+#define MOTOR_VEL_MAX_RPM           300     // 速度模式限幅 (RPM)
+
+// 多路径点连续运动 (motor_traj.c)
+#define MOTOR_TRAJ_MAX_POINTS       16      // 单条路径最多路径点
+#define MOTOR_TRAJ_PERIOD_MS        10      // 速度设定下发周期 (ms), 100Hz
+#define MOTOR_TRAJ_ACC_MM_S2        1400.0f // 轮速加速度限值 (mm/s^2), 与位置模式acc=200相当
+#define MOTOR_TRAJ_JERK_MM_S3       20000.0f// 轮速加加速度限值 (mm/s^3)
+#define MOTOR_TRAJ_DRIVER_ACC       240     // 驱动器跟随设定的加速度档位
+
+// 航向保持 (速度模式连续PI, 与多路径点运动共用控制周期)
+#define MOTOR_YAW_KP                3.0f    // 比例增益 ((度/s)/度)
+#define MOTOR_YAW_KI                1.0f    // 积分增益 ((度/s)/(度*s))
+#define MOTOR_YAW_INTEG_LIMIT       10.0f   // 积分限幅 (度*s)
+#define MOTOR_YAW_W_MAX_DEG_S       60.0f   // 修正角速度限幅 (度/s)
+#define MOTOR_YAW_MAX_READ_FAIL     20      // DMP连续读取失败超过此次数则停止修正
+#define MOTOR_YAW_SETTLE_MS         500     // 运动结束后原地收敛的最长时间 (ms)
+
+// 里程计 (motor_odom.c): 四轮S_CPOS + DMP航向融合
+#define MOTOR_ODOM_PERIOD_MS        20      // 四轮S_CPOS轮询周期 (ms), 50Hz
+#define MOTOR_ODOM_YAW_GAIN         0.2f    // 每周期航向向DMP修正的比例 (0~1)
+
+// 预测停车旋转 (motor_turn.c)
+#define MOTOR_TURN_PERIOD_MS        5       // DMP航向读取周期 (ms)
+#define MOTOR_TURN_ACC              220     // 旋转起停加速度档位
+#define MOTOR_TURN_LATENCY_MS       10      // DMP输出 + 停车命令下发延迟补偿 (ms)
+#define MOTOR_TURN_RATE_FILTER      0.5f    // 角速度一阶滤波系数 (0~1)
+#define MOTOR_TURN_STILL_DPS        2.0f    // 角速度低于此值视为停稳 (度/s)
+#define MOTOR_TURN_SETTLE_MS        300     // 停车后等待停稳的最长时间 (ms)
+#define MOTOR_TURN_MAX_CORRECT      3       // 最多补偿次数
+#define MOTOR_TURN_CORRECT_RPM      20      // 补偿转速 (RPM)
+#define MOTOR_TURN_TIMEOUT_MS       5000    // 单次旋转超时 (ms)
+
+// 最短用时规划 (Motor_Plan_Move): 车轮滑移与电机电流限值
+#define MOTOR_SLIP_ACC_MM_S2        2000.0f // 车轮不打滑的最大线加速度 (mm/s^2)
+#define MOTOR_TORQUE_ACC_RPM_S      1500.0f // 电流限幅下零速可达加速度 (RPM/s)
+#define MOTOR_TORQUE_RPM_ZERO       400.0f  // 电流限幅下力矩降为零的转速 (RPM)
+#define MOTOR_PLAN_RPM_MAX          200     // 规划速度上限 (RPM)
+#define MOTOR_MOVE_LOG_SIZE         16      // 运动用时记录条数
+
+// 到位窗口默认值 (电机轴角度): 位置误差与转速都在窗口内即视为运动完成
+#define MOTOR_INPOS_WINDOW_DEG      2.0f    // 位置误差窗口 (度)
+#define MOTOR_INPOS_VEL_RPM         5       // 转速窗口 (RPM)
+#define MOTOR_INPOS_POLL_MS         10      // S_TPOS/S_CPOS/S_VEL 轮询周期 (ms)
+#define MOTOR_INPOS_READ_TIMEOUT_MS 5       // 单次读取等待回复超时 (ms)
+#define MOTOR_ARRIVAL_CHECK_MS      50      // 到位返回未到时读取S_FLAG核对的周期 (ms)
+
+/* ==================== 类型定义 ==================== */
+
+/**
+ * @brief 路径点: 相对路径起点的位姿 (起始车体坐标系)
+ */
+typedef struct {
+    float x_mm;             // 正值前方
+    float y_mm;             // 正值右方
+    float theta_deg;        // 航向, 正值逆时针
+} MotorWaypoint_t;
+
+/**
+ * @brief 里程计位姿 (场地坐标系, Motor_Odom_Set_Pose设定原点)
+ * @note 轴向与Motor_Move_XYTheta/MotorWaypoint_t一致: x前, y右, 逆时针为正
+ */
+typedef struct {
+    float    x_mm;          // 正值前方 (设定原点时的车头方向)
+    float    y_mm;          // 正值右方 (设定原点时的车体右侧)
+    float    theta_deg;     // 航向 (-180~180], 正值逆时针
+    uint32_t tick;          // 所用四轮编码器读数的平均采样时刻 (HAL_GetTick)
+    uint32_t count;         // 更新计数
+} MotorPose_t;
+
+/**
+ * @brief 单次运动的速度曲线规划
+ */
+typedef struct {
+    uint16_t rpm;           // 设定速度 (RPM)
+    uint8_t  acc;           // 加速度档位
+    float    t_pred_s;      // 预测用时 (s)
+} MotorMovePlan_t;
+
+/**
+ * @brief 运动用时记录: 预测与实际对比, 用于校核规划模型
+ */
+typedef struct {
+    float    dist_mm;       // 行程最长车轮的行程 (mm)
+    uint16_t rpm;
+    uint8_t  acc;
+    uint16_t pred_ms;       // 预测用时
+    uint16_t actual_ms;     // 下发到四轮全部到位的实际用时
+} MotorMoveLog_t;
+
+/**
+ * @brief 最近一次预测停车旋转的统计
+ */
+typedef struct {
+    uint32_t time_ms;       // 总耗时 (含补偿)
+    uint8_t  corrections;   // 补偿次数, 0表示一次到位
+    float    stop_err_deg;  // 预测停车停稳后的误差 (目标-实际)
+    float    final_err_deg; // 最终误差
+    float    alpha_dps2;    // 停车预测所用角加速度 (度/s^2)
+} MotorTurnStats_t;
+
 /**
  * @brief 初始化电机驱动模块 (位置模式)
  */
@@ -73,19 +210,68 @@ void Motor_Move_Forward_WithYawHold(float distance_mm, float target_yaw_deg,
  * @param tolerance_deg 允许偏差(度), 建议±2°
  * @param speed_rpm 速度(RPM), 0表示使用默认值
  * @note 自动分段移动并修正航向偏差,防止平移时车体旋转
+ *       motor.c原有接口, 保留正值左移; 其余底盘接口与位姿统一为正值右移,
+ *       新代码使用Motor_Traj_Lateral_YawHold
  */
 void Motor_Move_Lateral_WithYawHold(float distance_mm, float target_yaw_deg,
                                      float tolerance_deg, uint16_t speed_rpm,float segment) ;
 
+/**
+ * @brief 连续航向保持的前进运动 (motor_traj.c, 速度模式)
+ * @param distance_mm 移动距离(mm), 正值前进, 负值后退
+ * @param target_yaw_deg 目标航向角(度), 通常是起始yaw角
+ * @param tolerance_deg 允许偏差(度), 建议±2°
+ * @param speed_rpm 速度(RPM), 0表示使用默认值
+ * @return 0=完成, 1=路径规划失败, 2=车轮堵转或速度指令发送失败(已停车)
+ * @note 每MOTOR_TRAJ_PERIOD_MS读取DMP航向并由PI控制器修正角速度, 全程不停车;
+ *       行驶方向按目标航向保持直线. 结束后偏差仍超过tolerance则原地收敛.
+ *       替代motor.c中分段停车修正的Motor_Move_Forward_WithYawHold, 调用处逐个迁移
+ */
+uint8_t Motor_Traj_Forward_YawHold(float distance_mm, float target_yaw_deg,
+                                   float tolerance_deg, uint16_t speed_rpm);
+
+/**
+ * @brief 连续航向保持的平移运动 (motor_traj.c, 速度模式)
+ * @param distance_mm 移动距离(mm), 正值右移, 负值左移 (与Motor_Move_XYTheta一致,
+ *                    与Motor_Move_Lateral_WithYawHold相反)
+ * @return 0=完成, 1=路径规划失败, 2=车轮堵转或速度指令发送失败(已停车)
+ * @note 与Motor_Traj_Forward_YawHold相同的连续航向保持, 不需要分段长度参数
+ */
+uint8_t Motor_Traj_Lateral_YawHold(float distance_mm, float target_yaw_deg,
+                                   float tolerance_deg, uint16_t speed_rpm);
+
 /**
  * @brief 基于DMP反馈的精确90°旋转
  * @param clockwise 1=顺时针, 0=逆时针
  * @param speed_rpm 速度(RPM), 0表示使用默认值
  * @return 0=成功, 1=MPU读取失败
  * @note 使用DMP实时姿态解算,闭环控制到达±2°精度
+ *       改为调用Motor_Rotate_DMP_Predict后另有2=车轮堵转, 3=超时
  */
 uint8_t Motor_Rotate_90_DMP(uint8_t clockwise, uint16_t speed_rpm);
 
+/**
+ * @brief 预测停车的DMP闭环旋转, 通常一次到位
+ * @param angle_deg 旋转角度(度), 正值逆时针
+ * @param tolerance_deg 允许偏差(度)
+ * @param speed_rpm 轮速(RPM), 0表示使用默认值
+ * @return 0=成功, 1=MPU连续读取失败, 2=车轮堵转, 3=旋转或补偿超时(MOTOR_TURN_TIMEOUT_MS)
+ * @note 速度模式旋转, 每MOTOR_TURN_PERIOD_MS读取航向与角速度,
+ *       按实测起转角加速度预测停车角, 达到目标时下发停车;
+ *       停稳后仍超差才补发剩余脉冲. 单次读取失败在下一周期重试,
+ *       连续超过MOTOR_YAW_MAX_READ_FAIL次才返回1.
+ *       Motor_Rotate_90_DMP应实现为
+ *       Motor_Rotate_DMP_Predict(clockwise ? -90 : 90, 2.0f, speed_rpm);
+ *       motor.c不在本快照中, 目前只有主机替身(host/stubs/motor.c)按此切换,
+ *       固件侧的motor.c需同样修改
+ */
+uint8_t Motor_Rotate_DMP_Predict(float angle_deg, float tolerance_deg, uint16_t speed_rpm);
+
+/**
+ * @brief 读取最近一次Motor_Rotate_DMP_Predict的统计
+ */
+const MotorTurnStats_t *Motor_Get_Turn_Stats(void);
+
 /**
  * @brief 原地航向矫正(修正到目标航向)
  * @param target_yaw_deg 目标航向角(度)
@@ -96,4 +282,201 @@ uint8_t Motor_Rotate_90_DMP(uint8_t clockwise, uint16_t speed_rpm);
  */
 uint8_t Motor_Correct_Yaw(float target_yaw_deg, float tolerance_deg, uint16_t speed_rpm);
 
+/**
+ * @brief 四轮同步位置运动 (一次DMA突发发出)
+ * @param clk 各轮脉冲数, 顺序为 左前/右前/左后/右后; 正值dir=0(CW), 负值dir=1(CCW)
+ * @param rpm 各轮速度(RPM)
+ * @param acc 加速度档位 0~255
+ * @return true=命令已入队, false=发送队列背压超时
+ * @note 四个位置帧(snF=1)与广播同步帧连续打包, 帧间无间隙, 四轮同时启动;
+ *       Motor_Move_Forward/Lateral/Rotate 计算各轮脉冲后统一经由本函数下发
+ */
+bool Motor_Move_Wheels_Sync(const int32_t clk[MOTOR_WHEEL_COUNT],
+                            const uint16_t rpm[MOTOR_WHEEL_COUNT], uint8_t acc);
+
+/**
+ * @brief 平移与旋转合成为一次四轮同步运动 (车体坐标系)
+ * @param dx_mm      终点前后位移, 正值前进 (mm, 起始车体坐标系)
+ * @param dy_mm      终点左右位移, 正值向右 (mm), 与Motor_Move_Lateral一致
+ * @param dtheta_deg 转角, 正值逆时针 (度), 与Motor_Move_Rotate一致
+ * @param speed_rpm  行程最长车轮的速度(RPM), 0表示按Motor_Plan_Move自动选取最短用时的速度与加速度
+ * @return true=命令已入队, false=发送队列背压超时
+ * @note 按麦克纳姆逆运动学计算各轮脉冲; 各轮速度与加速度按行程等比缩放,
+ *       梯形曲线形状相同, 四轮同时启动并同时到位. 边走边转时车体沿圆弧运动,
+ *       平移量已按圆弧换算, 终点位置仍为起始坐标系下的(dx, dy).
+ *       立即返回, 用Motor_Wait_All(MOTOR_MASK_WHEELS, ...)等待完成
+ */
+bool Motor_Move_XYTheta(float dx_mm, float dy_mm, float dtheta_deg, uint16_t speed_rpm);
+
+/**
+ * @brief 速度模式: 设定车体速度, 四轮速度帧同步生效
+ * @param vx_mm_s 前进速度 (mm/s)
+ * @param vy_mm_s 向右速度 (mm/s)
+ * @param w_deg_s 角速度, 正值逆时针 (度/s)
+ * @param acc     驱动器加速度档位, 流式设定时取较大值让驱动器紧跟设定
+ * @return true=命令已入队, false=发送队列背压超时, 此时已逐轮下发立即停车
+ * @note 各轮速度取整为RPM, 舍入误差累计到下一次设定, 周期性调用时平均速度无偏
+ */
+bool Motor_Set_Chassis_Velocity(float vx_mm_s, float vy_mm_s, float w_deg_s, uint8_t acc);
+
+/**
+ * @brief 依次经过各路径点的连续运动, 拐点处平滑过渡不停车
+ * @param wp        路径点数组, 坐标相对起点, 最后一点为终点
+ * @param count     路径点数量, 不超过MOTOR_TRAJ_MAX_POINTS
+ * @param speed_rpm 轮速上限(RPM), 0表示使用默认值
+ * @return 0=完成, 1=参数错误, 2=车轮堵转或速度指令发送失败(已停车)
+ * @note 阻塞执行: 每MOTOR_TRAJ_PERIOD_MS以速度模式下发四轮同步速度;
+ *       拐点附近路径向内侧切角, 经过的是拐点附近而非拐点本身,
+ *       需要精确经过的点应拆成两次调用
+ */
+uint8_t Motor_Traj_Follow(const MotorWaypoint_t *wp, uint8_t count, uint16_t speed_rpm);
+
+/**
+ * @brief 预估Motor_Traj_Follow的执行时间
+ * @return 时间(s), 参数错误返回0
+ */
+float Motor_Traj_Duration(const MotorWaypoint_t *wp, uint8_t count, uint16_t speed_rpm);
+
+/**
+ * @brief 启动里程计: 以MOTOR_ODOM_PERIOD_MS周期轮询四轮S_CPOS
+ * @note 位姿从当前位置继续累加, 需要时先调用Motor_Odom_Set_Pose.
+ *       里程计是协作式的: 轮询与积分只在Motor_Background_Process中执行,
+ *       长时间不调用时位姿不更新. 积分用的是编码器绝对位置的差值,
+ *       恢复调用后中间的位移一次补上, 不会丢失, 只是该区间按中点航向近似
+ */
+void Motor_Odom_Start(void);
+
+/**
+ * @brief 停止里程计并取消四轮S_CPOS轮询
+ */
+void Motor_Odom_Stop(void);
+
+/**
+ * @brief 设定当前位姿 (如在已知位置重新定位)
+ * @note 航向与DMP的对应关系在下一次更新时重新对齐
+ */
+void Motor_Odom_Set_Pose(float x_mm, float y_mm, float theta_deg);
+
+/**
+ * @brief 提供已读取的DMP航向, 本周期内里程计不再重复读取DMP
+ */
+void Motor_Odom_Feed_Yaw(float yaw_deg);
+
+/**
+ * @brief 里程计更新, 四轮都有新读数时积分一次 (由Motor_Background_Process调用)
+ * @note 不在中断中运行; 位姿的实时性取决于主循环/等待循环调用后台任务的频率
+ */
+void Motor_Odom_Process(void);
+
+/**
+ * @brief 读取最新位姿, 可在任意上下文调用
+ */
+void Motor_Odom_Get(MotorPose_t *out);
+
+/**
+ * @brief 按里程计运动到场地坐标系中的目标位姿 (单次XYTheta运动)
+ * @param x_mm/y_mm 目标位置 (场地坐标系, y正值右方, 与MotorPose_t一致)
+ * @param theta_deg 目标航向
+ * @return false=发送失败
+ */
+bool Motor_Move_To(float x_mm, float y_mm, float theta_deg, uint16_t speed_rpm);
+
+/**
+ * @brief 电机后台任务: 发送队列续传 + 遥测轮询 + 里程计 + 运动用时记录, 在主循环及各等待循环中调用
+ */
+void Motor_Background_Process(void);
+
+/**
+ * @brief 求车轮行程的最短用时梯形曲线
+ * @param wheel_mm 车轮行程 (mm, 取绝对值)
+ * @param plan 输出速度/加速度档位/预测用时
+ * @note 加速度同时受车轮滑移(MOTOR_SLIP_ACC_MM_S2)与电流限幅下随转速下降的
+ *       力矩约束, 短行程得到高加速度三角形曲线, 长行程得到较高巡航速度
+ */
+void Motor_Plan_Move(float wheel_mm, MotorMovePlan_t *plan);
+
+/**
+ * @brief 读取运动用时记录, 按时间先后排列
+ * @param out 输出数组
+ * @param max 数组容量
+ * @return 实际条数
+ * @note 只记录Motor_Move_XYTheta发起且四轮正常到位的运动
+ */
+uint8_t Motor_Get_Move_Log(MotorMoveLog_t *out, uint8_t max);
+
+/**
+ * @brief 检查待记录运动是否完成 (由Motor_Background_Process调用)
+ */
+void Motor_Move_Log_Process(void);
+
+/**
+ * @brief 到位返回丢失补偿 (由Motor_Background_Process调用)
+ * @note 同一路串口的两个驱动器同时到位时两帧到位返回在RX线上冲突, 两者都收不到.
+ *       已下发运动而未收到到位返回的电机每MOTOR_ARRIVAL_CHECK_MS读取一次S_FLAG,
+ *       读到到位位时由emm_rx置到位位; 每路串口同一时刻只发出一个读取
+ */
+void Motor_Arrival_Process(void);
+
+/**
+ * @brief 等待掩码内全部电机到位
+ * @param mask 电机位掩码 (MOTOR_MASK / MOTOR_MASK_WHEELS)
+ * @param timeout_ms 超时时间(ms)
+ * @return 掩码内已到位的电机, 等于mask表示成功
+ * @note 掩码内任一电机堵转时提前返回, 可用Motor_Get_Stall_Mask()区分超时与堵转;
+ *       到位位在下发运动命令时清除 (Motor_Move_Wheels_Sync自动处理,
+ *       直接调用Emm_V5_Pos_Control前需先调用Motor_Arm_Arrival)
+ */
+uint32_t Motor_Wait_All(uint32_t mask, uint32_t timeout_ms);
+
+/**
+ * @brief 等待掩码内任一电机到位
+ * @param mask 电机位掩码
+ * @param timeout_ms 超时时间(ms)
+ * @return 掩码内已到位的电机, 0表示超时或堵转
+ */
+uint32_t Motor_Wait_Any(uint32_t mask, uint32_t timeout_ms);
+
+/**
+ * @brief 等待到指定时刻 (等待期间处理电机后台任务), 用于固定周期的控制循环
+ * @param tick 目标时刻 (HAL_GetTick), 已过去则立即返回
+ * @return true=到时, false=等待中车轮堵转
+ */
+bool Motor_Wait_Until(uint32_t tick);
+
+/**
+ * @brief 清除电机到位位, 在下发运动命令之前调用
+ * @note 同时登记这些电机等待到位返回, 见Motor_Arrival_Process
+ */
+void Motor_Arm_Arrival(uint32_t mask);
+
+/**
+ * @brief 获取堵转电机位掩码
+ */
+uint32_t Motor_Get_Stall_Mask(void);
+
+/**
+ * @brief 解除堵转保护并清除堵转位
+ */
+void Motor_Clear_Stall(uint32_t mask);
+
+/**
+ * @brief 设置电机到位窗口
+ * @param mask 电机位掩码
+ * @param window_deg 位置误差窗口(度, 电机轴), 0表示只接受到位返回
+ * @param vel_rpm 转速窗口(RPM)
+ */
+void Motor_Set_InPosition_Window(uint32_t mask, float window_deg, uint16_t vel_rpm);
+
+/**
+ * @brief 等待掩码内全部电机进入到位窗口
+ * @param mask 电机位掩码
+ * @param timeout_ms 超时时间(ms)
+ * @return 掩码内已完成的电机, 等于mask表示成功
+ * @note 每MOTOR_INPOS_POLL_MS读取一次S_TPOS/S_CPOS/S_VEL, 距最终目标的误差与转速都在窗口内即完成
+ *       (S_PERR为跟随误差, 加速阶段也很小, 不作判据),
+ *       不必等待最后零点几度的步进电机整定; 收到到位返回也视为完成.
+ *       用于Motor_Move_Forward_WithYawHold分段等待与Gripper_Lift等对残余误差不敏感的场合
+ */
+uint32_t Motor_Wait_InPosition(uint32_t mask, uint32_t timeout_ms);
+
 #endif /* __MOTOR_H__ */
@@ -0,0 +1,228 @@
+/**
+  ******************************************************************************
+  * @file    motor_odom.c
+  * @brief   底盘里程计: 车轮编码器 + DMP航向融合
+  * @details 后台以固定频率轮询四轮S_CPOS, 四个轮子都有新读数后:
+  *          - 麦克纳姆正运动学求车体系位移与转角
+  *          - 航向用车轮转角预测, 再向DMP航向做互补修正(抑制打滑)
+  *          - 按区间中点航向累加到场地坐标, 以序号锁发布带时间戳的位姿
+  *          场地坐标系与Motor_Move_XYTheta相同: x前, y右, 逆时针为正.
+  *          轮询与积分在Motor_Background_Process中协作执行, 不占用定时器中断
+  ******************************************************************************
+  */
+
+#include "motor.h"
+#include "emm_bus.h"
+#include "emm_rx.h"
+#include "emm_poll.h"
+#include "inv_mpu.h"
+#include <math.h>
+
+/* ==================== 私有变量 ==================== */
+
+static const uint8_t s_wheel_addr[MOTOR_WHEEL_COUNT] = {
+    MOTOR_WHEEL_ADDR_FL, MOTOR_WHEEL_ADDR_FR, MOTOR_WHEEL_ADDR_RL, MOTOR_WHEEL_ADDR_RR
+};
+
+static const int8_t s_wheel_sign[MOTOR_WHEEL_COUNT] = {
+    MOTOR_WHEEL_SIGN_FL, MOTOR_WHEEL_SIGN_FR, MOTOR_WHEEL_SIGN_RL, MOTOR_WHEEL_SIGN_RR
+};
+
+static bool     s_running = false;
+static bool     s_have_base = false;
+static int32_t  s_cpos_last[MOTOR_WHEEL_COUNT];
+static uint8_t  s_cpos_seq[MOTOR_WHEEL_COUNT];
+static uint32_t s_last_tick = 0;
+
+static float    s_x = 0.0f, s_y = 0.0f, s_th = 0.0f;    // mm, mm, rad
+static float    s_yaw_ref_deg = 0.0f;                   // 航向0对应的DMP读数
+static bool     s_yaw_ref_valid = false;
+static float    s_yaw_fed_deg = 0.0f;                   // 其他模块读到的DMP航向
+static uint32_t s_yaw_fed_tick = 0;
+static bool     s_yaw_fed = false;
+
+static __IO uint32_t s_pose_seq = 0;                    // 写入时为奇数
+static MotorPose_t   s_pose;
+
+/* ==================== 私有函数 ==================== */
+
+static float wrap_pi(float a)
+{
+    while (a > 3.14159265f)  a -= 6.2831853f;
+    while (a < -3.14159265f) a += 6.2831853f;
+    return a;
+}
+
+/**
+ * @brief 取最新DMP航向 (度): 优先使用本周期内其他模块已读到的值, 避免重复读I2C
+ * @return false=读取失败
+ */
+static bool odom_yaw(float *yaw_deg)
+{
+    float pitch, roll;
+
+    if (s_yaw_fed && HAL_GetTick() - s_yaw_fed_tick < MOTOR_ODOM_PERIOD_MS) {
+        *yaw_deg = s_yaw_fed_deg;
+        return true;
+    }
+    return mpu_dmp_get_data(&pitch, &roll, yaw_deg) == 0;
+}
+
+static void publish(uint32_t tick)
+{
+    s_pose_seq++;
+    s_pose.x_mm = s_x;
+    s_pose.y_mm = s_y;
+    s_pose.theta_deg = s_th * 180.0f / 3.14159265f;
+    s_pose.tick = tick;
+    s_pose.count++;
+    s_pose_seq++;
+}
+
+/**
+ * @brief 四轮都有新的S_CPOS时执行一次积分
+ */
+static void odom_update(void)
+{
+    const float mm_per_count = 3.14159265f * MOTOR_WHEEL_DIAMETER_MM / (float)EMM_COUNTS_PER_REV;
+    const float k_rot = MOTOR_CHASSIS_HALF_L_MM + MOTOR_CHASSIS_HALF_W_MM;
+    EmmRxSlot_t slot[MOTOR_WHEEL_COUNT];
+    float d[MOTOR_WHEEL_COUNT];
+    float bx, by, dth, th_mid, yaw;
+    uint32_t tick_sum = 0;
+    uint8_t i;
+
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        if (Emm_Rx_Param_Seq(s_wheel_addr[i], S_CPOS) == s_cpos_seq[i]) {
+            return;
+        }
+    }
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        s_cpos_seq[i] = Emm_Rx_Param_Seq(s_wheel_addr[i], S_CPOS);
+        Emm_Rx_Get(s_wheel_addr[i], &slot[i]);
+        tick_sum += slot[i].param_tick[S_CPOS];
+    }
+
+    if (!s_have_base) {
+        for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+            s_cpos_last[i] = slot[i].cpos;
+        }
+        s_have_base = true;
+        return;
+    }
+
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        d[i] = (float)(int32_t)(slot[i].cpos - s_cpos_last[i]) * mm_per_count * (float)s_wheel_sign[i];
+        s_cpos_last[i] = slot[i].cpos;
+    }
+
+    // 正运动学 (chassis_ik的逆, 车体系x前/y左, 逆时针为正)
+    bx  = ( d[0] + d[1] + d[2] + d[3]) / 4.0f;
+    by  = (-d[0] + d[1] + d[2] - d[3]) / 4.0f;
+    dth = (-d[0] + d[1] - d[2] + d[3]) / (4.0f * k_rot);
+
+    // 场地系y右: 车头方向(cos, -sin), 车体左方(-sin, -cos)
+    th_mid = s_th + 0.5f * dth;
+    s_x += bx * cosf(th_mid) - by * sinf(th_mid);
+    s_y += -bx * sinf(th_mid) - by * cosf(th_mid);
+    s_th = wrap_pi(s_th + dth);
+
+    // 航向互补修正: 车轮转角响应快但会打滑, DMP航向不受打滑影响
+    if (odom_yaw(&yaw)) {
+        float imu_th;
+        if (!s_yaw_ref_valid) {
+            s_yaw_ref_deg = yaw - s_th * 180.0f / 3.14159265f;
+            s_yaw_ref_valid = true;
+        }
+        imu_th = Motor_Get_Rotation_From_Yaw(s_yaw_ref_deg, yaw) * 3.14159265f / 180.0f;
+        s_th = wrap_pi(s_th + MOTOR_ODOM_YAW_GAIN * wrap_pi(imu_th - s_th));
+    }
+
+    publish(tick_sum / MOTOR_WHEEL_COUNT);
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Motor_Odom_Start(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        Emm_Poll_Config(s_wheel_addr[i], S_CPOS, 1000U / MOTOR_ODOM_PERIOD_MS);
+        s_cpos_seq[i] = Emm_Rx_Param_Seq(s_wheel_addr[i], S_CPOS);
+    }
+    s_have_base = false;
+    s_running = true;
+    s_last_tick = HAL_GetTick();
+}
+
+void Motor_Odom_Stop(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        Emm_Poll_Config(s_wheel_addr[i], S_CPOS, 0);
+    }
+    s_running = false;
+}
+
+void Motor_Odom_Set_Pose(float x_mm, float y_mm, float theta_deg)
+{
+    s_x = x_mm;
+    s_y = y_mm;
+    s_th = wrap_pi(theta_deg * 3.14159265f / 180.0f);
+    s_yaw_ref_valid = false;        // 下一次DMP读数重新对齐航向
+    publish(HAL_GetTick());
+}
+
+void Motor_Odom_Feed_Yaw(float yaw_deg)
+{
+    s_yaw_fed_deg = yaw_deg;
+    s_yaw_fed_tick = HAL_GetTick();
+    s_yaw_fed = true;
+}
+
+void Motor_Odom_Process(void)
+{
+    if (!s_running || HAL_GetTick() - s_last_tick < MOTOR_ODOM_PERIOD_MS / 2U) {
+        return;
+    }
+    s_last_tick = HAL_GetTick();
+    odom_update();
+}
+
+void Motor_Odom_Get(MotorPose_t *out)
+{
+    uint32_t seq;
+
+    do {
+        seq = s_pose_seq;
+        *out = s_pose;
+    } while ((seq & 1U) || seq != s_pose_seq);
+}
+
+bool Motor_Move_To(float x_mm, float y_mm, float theta_deg, uint16_t speed_rpm)
+{
+    MotorPose_t p;
+    float dx, dy, th, c, sn, dth;
+
+    Motor_Odom_Get(&p);
+    th = p.theta_deg * 3.14159265f / 180.0f;
+    c = cosf(th);
+    sn = sinf(th);
+    dx = x_mm - p.x_mm;
+    dy = y_mm - p.y_mm;
+    dth = Motor_Get_Rotation_From_Yaw(p.theta_deg, theta_deg);
+
+    // 场地系 -> 当前车体系, 两者y轴都向右
+    return Motor_Move_XYTheta(c * dx - sn * dy, sn * dx + c * dy, dth, speed_rpm);
+}
+
+void Motor_Background_Process(void)
+{
+    Emm_Bus_Process();
+    Emm_Poll_Process();
+    Motor_Odom_Process();
+    Motor_Move_Log_Process();
+    Motor_Arrival_Process();
+}
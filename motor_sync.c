@@ -0,0 +1,540 @@
+/**
+  ******************************************************************************
+  * @file    motor_sync.c
+  * @brief   底盘四轮同步运动
+  * @details 把四轮的位置命令与同步触发打包成一次DMA突发,
+  *          消除逐帧发送造成的启动时间差(车体偏航的来源之一);
+  *          按电机地址分别等待到位, 独立运动可以并行执行;
+  *          支持基于S_TPOS-S_CPOS的到位窗口提前完成;
+  *          麦克纳姆逆运动学把平移+旋转合成为一次同步运动
+  ******************************************************************************
+  */
+
+#include "motor.h"
+#include "emm_bus.h"
+#include "emm_rx.h"
+#include "emm_poll.h"
+#include "Emm_V5.h"
+#include <math.h>
+
+/* ==================== 私有变量 ==================== */
+
+static const uint8_t s_wheel_addr[MOTOR_WHEEL_COUNT] = {
+    MOTOR_WHEEL_ADDR_FL, MOTOR_WHEEL_ADDR_FR, MOTOR_WHEEL_ADDR_RL, MOTOR_WHEEL_ADDR_RR
+};
+
+static const int8_t s_wheel_sign[MOTOR_WHEEL_COUNT] = {
+    MOTOR_WHEEL_SIGN_FL, MOTOR_WHEEL_SIGN_FR, MOTOR_WHEEL_SIGN_RL, MOTOR_WHEEL_SIGN_RR
+};
+
+static MotorMoveLog_t s_move_log[MOTOR_MOVE_LOG_SIZE];
+static uint8_t  s_move_log_head = 0;            // 下一条写入位置
+static uint8_t  s_move_log_count = 0;
+static MotorMoveLog_t s_move_pending;           // 已下发, 等待四轮到位
+static uint32_t s_move_start_tick = 0;
+static bool     s_move_is_pending = false;
+
+static uint32_t s_arrival_armed = 0;           // 已下发运动、尚未到位的电机
+static uint32_t s_arrival_todo = 0;             // 本轮尚未发出S_FLAG读取的电机
+static uint32_t s_arrival_next = 0;             // 下一轮核对时刻
+
+static float    s_inpos_window_deg[EMM_RX_MAX_ADDR];
+static uint16_t s_inpos_vel_rpm[EMM_RX_MAX_ADDR];
+static bool     s_inpos_init = false;
+
+/* ==================== 私有函数 ==================== */
+
+static void inpos_defaults(void)
+{
+    uint8_t addr;
+
+    if (s_inpos_init) {
+        return;
+    }
+    for (addr = 0; addr < EMM_RX_MAX_ADDR; addr++) {
+        s_inpos_window_deg[addr] = MOTOR_INPOS_WINDOW_DEG;
+        s_inpos_vel_rpm[addr] = MOTOR_INPOS_VEL_RPM;
+    }
+    s_inpos_init = true;
+}
+
+/**
+ * @brief 读取各电机S_TPOS/S_CPOS/S_VEL, 返回距最终目标与转速都在窗口内的电机
+ * @note 同一路串口的驱动器共用RX线, 每路同一时刻只发出一个读取 (Emm_Rx_Read_Begin),
+ *       收到回复或超时后再发下一个; 不同串口的读取并行进行.
+ *       S_PERR是实时设定位置与实际位置之差(跟随误差), 加速阶段同样很小, 不能用于判断到位;
+ *       读取命令与运动命令在同一串口队列中按序处理, 回复的S_TPOS已是本次运动的目标
+ */
+static uint32_t inpos_poll(uint32_t mask)
+{
+    static const SysParams_t k_param[3] = { S_TPOS, S_CPOS, S_VEL };
+    uint8_t  step[EMM_RX_MAX_ADDR] = { 0 };     // 已收到回复的参数个数
+    uint8_t  seq[EMM_RX_MAX_ADDR];
+    uint32_t sent_tick[EMM_RX_MAX_ADDR];
+    uint32_t sent = 0, todo = 0, done = 0;
+    uint8_t addr;
+
+    for (addr = 1; addr < EMM_RX_MAX_ADDR; addr++) {
+        if ((mask & MOTOR_MASK(addr)) && s_inpos_window_deg[addr] > 0.0f) {
+            todo |= MOTOR_MASK(addr);
+        }
+    }
+
+    while (todo != 0) {
+        for (addr = 1; addr < EMM_RX_MAX_ADDR; addr++) {
+            uint32_t bit = MOTOR_MASK(addr);
+            SysParams_t s = k_param[step[addr]];
+
+            if (!(todo & bit)) {
+                continue;
+            }
+            if (!(sent & bit)) {
+                if (Emm_Rx_Read_Begin(addr, s, MOTOR_INPOS_READ_TIMEOUT_MS)) {
+                    seq[addr] = Emm_Rx_Param_Seq(addr, s);
+                    sent_tick[addr] = HAL_GetTick();
+                    sent |= bit;
+                    Emm_V5_Read_Sys_Params(addr, s);
+                }
+            } else if (Emm_Rx_Param_Seq(addr, s) != seq[addr]) {
+                sent &= ~bit;
+                if (++step[addr] == 3U) {
+                    EmmRxSlot_t slot;
+                    float err_deg;
+
+                    todo &= ~bit;
+                    Emm_Rx_Get(addr, &slot);
+                    err_deg = EMM_COUNTS_TO_DEG(slot.tpos - slot.cpos);
+                    if (err_deg < 0.0f) err_deg = -err_deg;
+                    if (err_deg <= s_inpos_window_deg[addr] &&
+                        (uint16_t)ABS(slot.vel_rpm) <= s_inpos_vel_rpm[addr]) {
+                        done |= bit;
+                    }
+                }
+            } else if (HAL_GetTick() - sent_tick[addr] > MOTOR_INPOS_READ_TIMEOUT_MS) {
+                todo &= ~bit;       // 回复丢失, 本轮放弃该电机
+            }
+        }
+    }
+    return done;
+}
+
+static bool wheels_sync(const int32_t clk[MOTOR_WHEEL_COUNT],
+                        const uint16_t rpm[MOTOR_WHEEL_COUNT], const uint8_t acc[MOTOR_WHEEL_COUNT])
+{
+    EmmPosCmd_t cmd[MOTOR_WHEEL_COUNT];
+    uint8_t i;
+
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        cmd[i].addr = s_wheel_addr[i];
+        cmd[i].dir  = (clk[i] < 0) ? 1 : 0;
+        cmd[i].vel  = rpm[i];
+        cmd[i].acc  = acc[i];
+        cmd[i].clk  = (uint32_t)((clk[i] < 0) ? -clk[i] : clk[i]);
+        cmd[i].raF  = false;
+    }
+    Motor_Move_Log_Process();       // 上一次运动未经等待函数确认时在此收尾
+    s_move_is_pending = false;
+    Motor_Arm_Arrival(MOTOR_MASK_WHEELS);
+    return Emm_Bus_Sync_Pos_Routed(cmd, MOTOR_WHEEL_COUNT);
+}
+
+/**
+ * @brief 麦克纳姆逆运动学 (x前/y左, 逆时针为正)
+ * @param x,y 车体平移 (mm 或 mm/s)
+ * @param th  转角 (rad 或 rad/s)
+ * @param wheel 输出各轮线位移/线速度, 顺序 左前/右前/左后/右后 (未乘安装方向)
+ */
+static void chassis_ik(float x, float y, float th, float wheel[MOTOR_WHEEL_COUNT])
+{
+    const float k_rot = MOTOR_CHASSIS_HALF_L_MM + MOTOR_CHASSIS_HALF_W_MM;
+
+    wheel[0] = x - y - k_rot * th;      // 左前
+    wheel[1] = x + y + k_rot * th;      // 右前
+    wheel[2] = x + y - k_rot * th;      // 左后
+    wheel[3] = x - y + k_rot * th;      // 右后
+}
+
+/**
+ * @brief 按行程比例缩放加速度档位
+ * @note 加速度 = 1RPM / ((256-acc)*50us), 比例为ratio时 (256-acc) 放大 1/ratio 倍
+ */
+static uint8_t scale_acc(uint8_t acc, float ratio)
+{
+    float span;
+
+    if (acc == 0 || ratio >= 1.0f) {
+        return acc;     // 0 = 无加减速曲线
+    }
+    span = (256.0f - (float)acc) / ratio;
+    return (span >= 255.0f) ? 1U : (uint8_t)lroundf(256.0f - span);
+}
+
+/**
+ * @brief 加速度档位 -> 加速度 (RPM/s), 0档返回0表示无加减速曲线
+ */
+static float acc_rpm_per_s(uint8_t acc)
+{
+    return acc ? 20000.0f / (256.0f - (float)acc) : 0.0f;
+}
+
+/**
+ * @brief 梯形(或三角形)速度曲线走完rev圈所需时间 (s)
+ */
+static float profile_time_s(float rev, float rpm, uint8_t acc)
+{
+    float a = acc_rpm_per_s(acc);
+
+    if (a <= 0.0f) {
+        return 60.0f * rev / rpm;
+    }
+    if (rpm * rpm > 60.0f * a * rev) {
+        return 2.0f * sqrtf(60.0f * rev / a);   // 达不到设定速度
+    }
+    return 60.0f * rev / rpm + rpm / a;
+}
+
+/**
+ * @brief 求在时间t内以加速度档位acc走完rev圈的速度 (RPM)
+ * @note 由 t = 60*rev/v + v/a 解出较小的根
+ */
+static float rpm_for_time(float rev, float t, uint8_t acc)
+{
+    float a = acc_rpm_per_s(acc);
+    float disc;
+
+    if (a <= 0.0f) {
+        return 60.0f * rev / t;
+    }
+    disc = a * a * t * t - 240.0f * a * rev;
+    return (disc > 0.0f) ? (a * t - sqrtf(disc)) / 2.0f : a * t / 2.0f;
+}
+
+/**
+ * @brief 电流限幅下某转速可用的加速度 (RPM/s)
+ * @note 步进电机力矩随转速近似线性下降, 梯形曲线全程使用同一加速度,
+ *       因此按峰值转速处的剩余力矩取值
+ */
+static float torque_acc_rpm_per_s(float rpm)
+{
+    return MOTOR_TORQUE_ACC_RPM_S * (1.0f - rpm / MOTOR_TORQUE_RPM_ZERO);
+}
+
+/**
+ * @brief 加速度 (RPM/s) -> 不超过该值的最大档位, 0表示低于最小档位
+ */
+static uint8_t acc_level_below(float a_rpm_s)
+{
+    float level = 256.0f - 20000.0f / a_rpm_s;
+
+    if (level < 1.0f) {
+        return 0;
+    }
+    return (level >= 255.0f) ? 255U : (uint8_t)level;
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Motor_Plan_Move(float wheel_mm, MotorMovePlan_t *plan)
+{
+    const float rev_per_mm = 1.0f / (3.14159265f * MOTOR_WHEEL_DIAMETER_MM);
+    const float slip_rpm_s = MOTOR_SLIP_ACC_MM_S2 * 60.0f * rev_per_mm;
+    float rev = fabsf(wheel_mm) * rev_per_mm;
+    float best_t = 0.0f;
+    uint16_t rpm;
+
+    plan->rpm = 1;
+    plan->acc = 1;
+    plan->t_pred_s = 0.0f;
+
+    // 逐档搜索: 转速越高可用加速度越低, 取用时最短者 (同用时取较低转速)
+    for (rpm = 1; rpm <= MOTOR_PLAN_RPM_MAX; rpm++) {
+        float a = torque_acc_rpm_per_s((float)rpm);
+        uint8_t acc;
+        float t;
+
+        if (a > slip_rpm_s) {
+            a = slip_rpm_s;
+        }
+        acc = acc_level_below(a);
+        if (acc == 0) {
+            break;
+        }
+        t = profile_time_s(rev, (float)rpm, acc);
+        if (best_t == 0.0f || t < best_t - 1e-4f) {
+            best_t = t;
+            plan->rpm = rpm;
+            plan->acc = acc;
+        }
+    }
+    plan->t_pred_s = best_t;
+}
+
+void Motor_Move_Log_Process(void)
+{
+    if (!s_move_is_pending ||
+        (Emm_Rx_Arrived_Mask() & MOTOR_MASK_WHEELS) != MOTOR_MASK_WHEELS) {
+        return;
+    }
+    s_move_pending.actual_ms = (uint16_t)(HAL_GetTick() - s_move_start_tick);
+    s_move_log[s_move_log_head] = s_move_pending;
+    s_move_log_head = (uint8_t)((s_move_log_head + 1U) % MOTOR_MOVE_LOG_SIZE);
+    if (s_move_log_count < MOTOR_MOVE_LOG_SIZE) {
+        s_move_log_count++;
+    }
+    s_move_is_pending = false;
+}
+
+uint8_t Motor_Get_Move_Log(MotorMoveLog_t *out, uint8_t max)
+{
+    uint8_t n = (max < s_move_log_count) ? max : s_move_log_count;
+    uint8_t first = (uint8_t)((s_move_log_head + MOTOR_MOVE_LOG_SIZE - n) % MOTOR_MOVE_LOG_SIZE);
+    uint8_t i;
+
+    for (i = 0; i < n; i++) {
+        out[i] = s_move_log[(first + i) % MOTOR_MOVE_LOG_SIZE];
+    }
+    return n;
+}
+
+bool Motor_Move_Wheels_Sync(const int32_t clk[MOTOR_WHEEL_COUNT],
+                            const uint16_t rpm[MOTOR_WHEEL_COUNT], uint8_t acc)
+{
+    const uint8_t accs[MOTOR_WHEEL_COUNT] = { acc, acc, acc, acc };
+
+    return wheels_sync(clk, rpm, accs);
+}
+
+bool Motor_Move_XYTheta(float dx_mm, float dy_mm, float dtheta_deg, uint16_t speed_rpm)
+{
+    const float clk_per_mm = (float)MOTOR_PULSES_PER_REV / (3.14159265f * MOTOR_WHEEL_DIAMETER_MM);
+    float th = dtheta_deg * 3.14159265f / 180.0f;
+    float bx = dx_mm;
+    float by = -dy_mm;          // 运动学计算使用 x前/y左 坐标系
+    float wheel_mm[MOTOR_WHEEL_COUNT];
+    float max_mm = 0.0f;
+    int32_t clk[MOTOR_WHEEL_COUNT];
+    uint16_t rpm[MOTOR_WHEEL_COUNT];
+    uint8_t acc[MOTOR_WHEEL_COUNT];
+    MotorMovePlan_t plan;
+    float t_s;
+    uint8_t i;
+
+    // 边走边转: 车体系速度恒定方向, 起始系位移 = (1/th)*[[S, C-1], [1-C, S]]*车体系位移, 求逆
+    if (fabsf(th) > 1e-4f) {
+        float sn = sinf(th), cs = cosf(th);
+        float det = 2.0f * (1.0f - cs);
+        float wx = bx, wy = by;
+        bx = th * ( sn * wx + (1.0f - cs) * wy) / det;
+        by = th * ((cs - 1.0f) * wx + sn * wy) / det;
+    }
+
+    chassis_ik(bx, by, th, wheel_mm);
+
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        if (fabsf(wheel_mm[i]) > max_mm) {
+            max_mm = fabsf(wheel_mm[i]);
+        }
+    }
+    if (max_mm * clk_per_mm < 0.5f) {
+        return true;
+    }
+
+    // 最长行程车轮: 未指定速度时按滑移/电流限值求最短用时的速度与加速度
+    if (speed_rpm == 0) {
+        Motor_Plan_Move(max_mm, &plan);
+    } else {
+        plan.rpm = speed_rpm;
+        plan.acc = MOTOR_XY_DEFAULT_ACC;
+        plan.t_pred_s = profile_time_s(max_mm * clk_per_mm / MOTOR_PULSES_PER_REV, (float)speed_rpm,
+                                       MOTOR_XY_DEFAULT_ACC);
+    }
+
+    // 加速度按行程等比缩放, 速度按最长行程车轮的用时反解, 各轮同时到位
+    // (档位取整或行程过短触底时, 反解速度仍可补偿)
+    t_s = plan.t_pred_s;
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        float ratio = fabsf(wheel_mm[i]) / max_mm;
+        clk[i] = (int32_t)lroundf(wheel_mm[i] * clk_per_mm) * s_wheel_sign[i];
+        acc[i] = scale_acc(plan.acc, ratio);
+        rpm[i] = (ratio >= 1.0f) ? plan.rpm
+               : (uint16_t)lroundf(rpm_for_time(fabsf(wheel_mm[i]) * clk_per_mm / MOTOR_PULSES_PER_REV,
+                                                t_s, acc[i]));
+        if (rpm[i] == 0) {
+            rpm[i] = 1;
+        }
+    }
+    if (!wheels_sync(clk, rpm, acc)) {
+        return false;
+    }
+
+    // 记录预测用时, 四轮到位后由Motor_Move_Log_Process补上实际用时
+    s_move_pending.dist_mm = max_mm;
+    s_move_pending.rpm = plan.rpm;
+    s_move_pending.acc = plan.acc;
+    s_move_pending.pred_ms = (uint16_t)lroundf(t_s * 1000.0f);
+    s_move_pending.actual_ms = 0;
+    s_move_start_tick = HAL_GetTick();
+    s_move_is_pending = true;
+    return true;
+}
+
+bool Motor_Set_Chassis_Velocity(float vx_mm_s, float vy_mm_s, float w_deg_s, uint8_t acc)
+{
+    static float residual[MOTOR_WHEEL_COUNT];
+    const float rpm_per_mm_s = 60.0f / (3.14159265f * MOTOR_WHEEL_DIAMETER_MM);
+    float wheel[MOTOR_WHEEL_COUNT];
+    EmmVelCmd_t cmd[MOTOR_WHEEL_COUNT];
+    uint8_t i;
+
+    chassis_ik(vx_mm_s, -vy_mm_s, w_deg_s * 3.14159265f / 180.0f, wheel);
+
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        float want = wheel[i] * rpm_per_mm_s * (float)s_wheel_sign[i];
+        long q;
+
+        // 速度只能整数RPM: 舍入误差累计到下一次, 平均速度不偏
+        if (want == 0.0f) {
+            residual[i] = 0.0f;
+        }
+        q = lroundf(want + residual[i]);
+        residual[i] += want - (float)q;
+        if (q > MOTOR_VEL_MAX_RPM) q = MOTOR_VEL_MAX_RPM;
+        if (q < -MOTOR_VEL_MAX_RPM) q = -MOTOR_VEL_MAX_RPM;
+
+        cmd[i].addr = s_wheel_addr[i];
+        cmd[i].dir  = (q < 0) ? 1 : 0;
+        cmd[i].vel  = (uint16_t)((q < 0) ? -q : q);
+        cmd[i].acc  = acc;
+    }
+    if (Emm_Bus_Sync_Vel_Routed(cmd, MOTOR_WHEEL_COUNT)) {
+        return true;
+    }
+    // 速度帧一路都未发出, 各轮仍按上一次设定运动: 逐轮立即停车, 不留失控的轮子
+    for (i = 0; i < MOTOR_WHEEL_COUNT; i++) {
+        residual[i] = 0.0f;
+        Emm_V5_Stop_Now(s_wheel_addr[i], false);
+    }
+    return false;
+}
+
+uint32_t Motor_Wait_All(uint32_t mask, uint32_t timeout_ms)
+{
+    uint32_t tickstart = HAL_GetTick();
+    uint32_t arrived;
+
+    while ((arrived = Emm_Rx_Arrived_Mask() & mask) != mask) {
+        Motor_Background_Process();
+        if ((Emm_Rx_Stall_Mask() & mask) || HAL_GetTick() - tickstart > timeout_ms) {
+            break;
+        }
+    }
+    Motor_Move_Log_Process();
+    return arrived;
+}
+
+uint32_t Motor_Wait_Any(uint32_t mask, uint32_t timeout_ms)
+{
+    uint32_t tickstart = HAL_GetTick();
+    uint32_t arrived;
+
+    while ((arrived = Emm_Rx_Arrived_Mask() & mask) == 0) {
+        Motor_Background_Process();
+        if ((Emm_Rx_Stall_Mask() & mask) || HAL_GetTick() - tickstart > timeout_ms) {
+            break;
+        }
+    }
+    return arrived;
+}
+
+bool Motor_Wait_Until(uint32_t tick)
+{
+    while ((int32_t)(HAL_GetTick() - tick) < 0) {
+        Motor_Background_Process();
+        if (Emm_Rx_Stall_Mask() & MOTOR_MASK_WHEELS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Motor_Arm_Arrival(uint32_t mask)
+{
+    Emm_Rx_Arm_Arrival(mask);
+    s_arrival_armed |= mask;
+    s_arrival_todo &= ~mask;
+    s_arrival_next = HAL_GetTick() + MOTOR_ARRIVAL_CHECK_MS;
+}
+
+void Motor_Arrival_Process(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint8_t addr;
+
+    s_arrival_armed &= ~(Emm_Rx_Arrived_Mask() | Emm_Rx_Stall_Mask());
+    s_arrival_todo &= s_arrival_armed;
+    if (s_arrival_todo == 0) {
+        if (s_arrival_armed == 0 || (int32_t)(now - s_arrival_next) < 0) {
+            return;
+        }
+        s_arrival_todo = s_arrival_armed;
+        s_arrival_next = now + MOTOR_ARRIVAL_CHECK_MS;
+    }
+    for (addr = 1; addr < EMM_RX_MAX_ADDR; addr++) {
+        if ((s_arrival_todo & MOTOR_MASK(addr)) &&
+            Emm_Rx_Read_Begin(addr, S_FLAG, MOTOR_INPOS_READ_TIMEOUT_MS)) {
+            s_arrival_todo &= ~MOTOR_MASK(addr);
+            Emm_V5_Read_Sys_Params(addr, S_FLAG);
+        }
+    }
+}
+
+uint32_t Motor_Get_Stall_Mask(void)
+{
+    return Emm_Rx_Stall_Mask();
+}
+
+void Motor_Clear_Stall(uint32_t mask)
+{
+    uint8_t addr;
+
+    for (addr = 1; addr < EMM_RX_MAX_ADDR; addr++) {
+        if (mask & MOTOR_MASK(addr)) {
+            Emm_V5_Reset_Clog_Pro(addr);
+        }
+    }
+    Emm_Rx_Clear_Stall(mask);
+}
+
+void Motor_Set_InPosition_Window(uint32_t mask, float window_deg, uint16_t vel_rpm)
+{
+    uint8_t addr;
+
+    inpos_defaults();
+    for (addr = 0; addr < EMM_RX_MAX_ADDR; addr++) {
+        if (mask & MOTOR_MASK(addr)) {
+            s_inpos_window_deg[addr] = window_deg;
+            s_inpos_vel_rpm[addr] = vel_rpm;
+        }
+    }
+}
+
+uint32_t Motor_Wait_InPosition(uint32_t mask, uint32_t timeout_ms)
+{
+    uint32_t tickstart = HAL_GetTick();
+    uint32_t last_poll = tickstart;
+    uint32_t done = 0;
+
+    inpos_defaults();
+    while (1) {
+        Motor_Background_Process();
+        done |= Emm_Rx_Arrived_Mask() & mask;
+        if (done == mask || (Emm_Rx_Stall_Mask() & mask) || HAL_GetTick() - tickstart > timeout_ms) {
+            break;
+        }
+        if (HAL_GetTick() - last_poll >= MOTOR_INPOS_POLL_MS) {
+            last_poll = HAL_GetTick();
+            done |= inpos_poll(mask & ~done);
+        }
+    }
+    return done;
+}
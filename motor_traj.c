@@ -0,0 +1,334 @@
+/**
+  ******************************************************************************
+  * @file    motor_traj.c
+  * @brief   底盘多路径点连续运动 (速度模式)
+  * @details 各路段以恒定车体速度行驶, 路段之间的速度切换用S曲线
+  *          (3u^2-2u^3) 在拐点两侧对称过渡, 中途不停车:
+  *          - 过渡时长由加速度与加加速度限值决定, 加速度连续
+  *          - 过渡对称, 速度积分与折线完全一致, 终点不受拐角平滑影响
+  *          - 按固定周期通过Emm_V5_Vel_Control(同步帧)下发四轮速度
+  *          航向保持运动复用同一套速度曲线, 每周期读取DMP航向,
+  *          PI控制器叠加角速度修正, 行驶中连续纠偏, 不再分段停车
+  ******************************************************************************
+  */
+
+#include "motor.h"
+#include "emm_bus.h"
+#include "emm_poll.h"
+#include "inv_mpu.h"
+#include <math.h>
+
+/* ==================== 私有类型 ==================== */
+
+typedef struct {
+    float vx, vy, w;        // 速度变化量 (起始坐标系, mm/s, mm/s, rad/s)
+    float t_mid;            // 过渡中心时刻 (s)
+    float tau;              // 过渡时长 (s)
+} TrajBlend_t;
+
+typedef struct {
+    bool  enabled;          // false=开环 (按指令角速度推算航向)
+    float yaw_ref_deg;      // 起始坐标系x轴对应的DMP航向
+    float integ;            // 积分项 (度*s)
+    float err_deg;          // 最近一次航向误差, 逆时针为正
+    uint8_t fail;           // 连续读取失败次数
+} TrajYawHold_t;
+
+/* ==================== 私有变量 ==================== */
+
+static TrajBlend_t s_blend[MOTOR_TRAJ_MAX_POINTS + 1];
+static uint8_t     s_blend_count = 0;
+static float       s_t_end = 0.0f;
+
+/* ==================== 私有函数 ==================== */
+
+/**
+ * @brief 速度(变化量)对应的最大轮速 (mm/s), 用于统一套用轮速限值
+ * @param heading 该段航向 (rad); 不转动时按车体系精确计算,
+ *                转动时车体系方向不断变化, 取上界 sqrt(2)*|v| + k*|w|
+ */
+static float wheel_delta(float vx, float vy, float w, float heading)
+{
+    const float k_rot = MOTOR_CHASSIS_HALF_L_MM + MOTOR_CHASSIS_HALF_W_MM;
+    float c, sn;
+
+    if (w != 0.0f) {
+        return 1.41421356f * sqrtf(vx * vx + vy * vy) + k_rot * fabsf(w);
+    }
+    c = cosf(heading);
+    sn = sinf(heading);
+    return fabsf(c * vx + sn * vy) + fabsf(-sn * vx + c * vy);
+}
+
+/**
+ * @brief 过渡时长: 满足加速度 1.5*dv/tau 与加加速度 6*dv/tau^2 限值
+ */
+static float blend_tau(float dv)
+{
+    float t_acc = 1.5f * dv / MOTOR_TRAJ_ACC_MM_S2;
+    float t_jerk = sqrtf(6.0f * dv / MOTOR_TRAJ_JERK_MM_S3);
+
+    return (t_acc > t_jerk) ? t_acc : t_jerk;
+}
+
+static float smooth_step(float u)
+{
+    if (u <= 0.0f) return 0.0f;
+    if (u >= 1.0f) return 1.0f;
+    return u * u * (3.0f - 2.0f * u);
+}
+
+/**
+ * @brief 规划: 折线各路段的恒速段与拐点过渡
+ * @return false=路径点数量错误
+ */
+static bool traj_plan(const MotorWaypoint_t *wp, uint8_t count, float v_max)
+{
+    float seg_t[MOTOR_TRAJ_MAX_POINTS];
+    float vx[MOTOR_TRAJ_MAX_POINTS + 1], vy[MOTOR_TRAJ_MAX_POINTS + 1], w[MOTOR_TRAJ_MAX_POINTS + 1];
+    float heading[MOTOR_TRAJ_MAX_POINTS + 1];
+    float px = 0.0f, py = 0.0f, pth = 0.0f;
+    float t;
+    uint8_t n = count, i, iter;
+
+    if (wp == NULL || count == 0 || count > MOTOR_TRAJ_MAX_POINTS) {
+        return false;
+    }
+
+    // 各路段以最大轮速匀速行驶所需时间 (坐标系: x前/y左, 逆时针为正)
+    for (i = 0; i < n; i++) {
+        float dx = wp[i].x_mm - px;
+        float dy = -wp[i].y_mm - py;
+        float dth = (wp[i].theta_deg * 3.14159265f / 180.0f) - pth;
+
+        seg_t[i] = wheel_delta(dx, dy, dth, pth) / v_max;
+        heading[i] = pth;
+        if (seg_t[i] < 1e-3f) {
+            seg_t[i] = 1e-3f;
+        }
+        vx[i] = dx / seg_t[i];
+        vy[i] = dy / seg_t[i];
+        w[i]  = dth / seg_t[i];
+        px = wp[i].x_mm;
+        py = -wp[i].y_mm;
+        pth = wp[i].theta_deg * 3.14159265f / 180.0f;
+    }
+    vx[n] = vy[n] = w[n] = 0.0f;
+    heading[n] = pth;
+
+    // 过渡重叠时拉长路段 (降低该段速度), 迭代几次即可收敛
+    for (iter = 0; iter < 4; iter++) {
+        for (i = 0; i <= n; i++) {
+            float pvx = i ? vx[i - 1] : 0.0f, pvy = i ? vy[i - 1] : 0.0f, pw = i ? w[i - 1] : 0.0f;
+            s_blend[i].vx = vx[i] - pvx;
+            s_blend[i].vy = vy[i] - pvy;
+            s_blend[i].w  = w[i] - pw;
+            s_blend[i].tau = blend_tau(wheel_delta(s_blend[i].vx, s_blend[i].vy, s_blend[i].w, heading[i]));
+        }
+        for (i = 0; i < n; i++) {
+            float need = 0.5f * (s_blend[i].tau + s_blend[i + 1].tau);
+            if (seg_t[i] < need) {
+                float k = seg_t[i] / need;
+                vx[i] *= k;
+                vy[i] *= k;
+                w[i]  *= k;
+                seg_t[i] = need;
+            }
+        }
+    }
+
+    // 第一次过渡从t=0开始
+    t = 0.5f * s_blend[0].tau;
+    for (i = 0; i <= n; i++) {
+        s_blend[i].t_mid = t;
+        if (i < n) {
+            t += seg_t[i];
+        }
+    }
+    s_blend_count = (uint8_t)(n + 1U);
+    s_t_end = t + 0.5f * s_blend[n].tau;
+    return true;
+}
+
+/**
+ * @brief t时刻的速度设定 (起始坐标系)
+ */
+static void traj_eval(float t, float *vx, float *vy, float *w)
+{
+    uint8_t i;
+
+    *vx = *vy = *w = 0.0f;
+    for (i = 0; i < s_blend_count; i++) {
+        const TrajBlend_t *b = &s_blend[i];
+        float k = (b->tau > 0.0f) ? smooth_step((t - b->t_mid) / b->tau + 0.5f)
+                                  : (t >= b->t_mid ? 1.0f : 0.0f);
+        *vx += k * b->vx;
+        *vy += k * b->vy;
+        *w  += k * b->w;
+    }
+}
+
+/**
+ * @brief 航向PI控制: 更新误差并返回角速度修正 (度/s)
+ * @param planned_deg 当前时刻规划航向 (起始坐标系, 逆时针为正)
+ */
+static float yaw_hold_update(TrajYawHold_t *h, float planned_deg, float dt)
+{
+    float pitch, roll, yaw, u;
+
+    if (mpu_dmp_get_data(&pitch, &roll, &yaw) != 0) {
+        // FIFO暂无新数据: 沿用上次误差, 连续失败过多则放弃修正
+        if (h->fail < 255U) h->fail++;
+        if (h->fail > MOTOR_YAW_MAX_READ_FAIL) {
+            return 0.0f;
+        }
+    } else {
+        h->fail = 0;
+        Motor_Odom_Feed_Yaw(yaw);
+        h->err_deg = Motor_Get_Rotation_From_Yaw(h->yaw_ref_deg, yaw) - planned_deg;
+    }
+
+    h->integ += h->err_deg * dt;
+    if (h->integ > MOTOR_YAW_INTEG_LIMIT)  h->integ = MOTOR_YAW_INTEG_LIMIT;
+    if (h->integ < -MOTOR_YAW_INTEG_LIMIT) h->integ = -MOTOR_YAW_INTEG_LIMIT;
+
+    u = -(MOTOR_YAW_KP * h->err_deg + MOTOR_YAW_KI * h->integ);
+    if (u > MOTOR_YAW_W_MAX_DEG_S)  u = MOTOR_YAW_W_MAX_DEG_S;
+    if (u < -MOTOR_YAW_W_MAX_DEG_S) u = -MOTOR_YAW_W_MAX_DEG_S;
+    return u;
+}
+
+/**
+ * @brief 按规划轨迹逐周期下发四轮速度, 结束或出错后停车
+ * @param hold 航向保持状态, enabled=false时按规划角速度开环转向
+ * @return 0=完成, 1=路径规划失败,
+ *         2=车轮堵转或速度指令发送失败 (与堵转相同处理: 立即结束并停车)
+ */
+static uint8_t traj_run(const MotorWaypoint_t *wp, uint8_t count, uint16_t speed_rpm, TrajYawHold_t *hold)
+{
+    const float dt = MOTOR_TRAJ_PERIOD_MS / 1000.0f;
+    float v_max, planned = 0.0f, heading = 0.0f;
+    uint32_t t0, tick;
+    uint8_t result = 0;
+
+    if (speed_rpm == 0) {
+        speed_rpm = MOTOR_XY_DEFAULT_RPM;
+    }
+    v_max = (float)speed_rpm * 3.14159265f * MOTOR_WHEEL_DIAMETER_MM / 60.0f;
+    if (!traj_plan(wp, count, v_max)) {
+        return 1;
+    }
+
+    t0 = tick = HAL_GetTick();
+    while (1) {
+        float t = (float)(tick - t0) / 1000.0f;
+        float vx, vy, w, w_deg, c, sn;
+
+        if (t >= s_t_end) {
+            break;
+        }
+
+        // 取本周期中点的设定值 (零阶保持下位移误差最小)
+        traj_eval(t + 0.5f * dt, &vx, &vy, &w);
+        w_deg = w * 180.0f / 3.14159265f;
+        planned += w_deg * 0.5f * dt;
+
+        if (hold->enabled) {
+            // 实测航向 = 规划航向 + 误差, 平移方向按实测航向转换到车体系
+            w_deg += yaw_hold_update(hold, planned, dt);
+            heading = (planned + hold->err_deg) * 3.14159265f / 180.0f;
+        } else {
+            heading = planned * 3.14159265f / 180.0f;
+        }
+        c = cosf(heading);
+        sn = sinf(heading);
+        if (!Motor_Set_Chassis_Velocity(c * vx + sn * vy, -(-sn * vx + c * vy), w_deg,
+                                        MOTOR_TRAJ_DRIVER_ACC)) {
+            result = 2;
+            break;
+        }
+        planned += w * 180.0f / 3.14159265f * 0.5f * dt;
+
+        tick += MOTOR_TRAJ_PERIOD_MS;
+        if (!Motor_Wait_Until(tick)) {
+            result = 2;
+            break;
+        }
+    }
+
+    Motor_Set_Chassis_Velocity(0.0f, 0.0f, 0.0f, MOTOR_TRAJ_DRIVER_ACC);
+    return result;
+}
+
+/**
+ * @brief 航向保持直线运动: 行驶中连续修正, 结束后残差超出容差再原地收敛
+ * @return 0=完成, 1=路径规划失败, 2=车轮堵转或速度指令发送失败
+ */
+static uint8_t yaw_hold_move(const MotorWaypoint_t *wp, float target_yaw_deg,
+                             float tolerance_deg, uint16_t speed_rpm)
+{
+    TrajYawHold_t hold = { true, target_yaw_deg, 0.0f, 0.0f, 0 };
+    uint32_t tickstart, tick;
+    uint8_t result;
+
+    result = traj_run(wp, 1, speed_rpm, &hold);
+    if (result != 0) {
+        return result;
+    }
+
+    tickstart = tick = HAL_GetTick();
+    hold.integ = 0.0f;
+    while (HAL_GetTick() - tickstart < MOTOR_YAW_SETTLE_MS) {
+        float w = yaw_hold_update(&hold, 0.0f, MOTOR_TRAJ_PERIOD_MS / 1000.0f);
+        if (hold.fail > MOTOR_YAW_MAX_READ_FAIL || fabsf(hold.err_deg) <= tolerance_deg) {
+            break;
+        }
+        if (!Motor_Set_Chassis_Velocity(0.0f, 0.0f, w, MOTOR_TRAJ_DRIVER_ACC)) {
+            result = 2;
+            break;
+        }
+        tick += MOTOR_TRAJ_PERIOD_MS;
+        if (!Motor_Wait_Until(tick)) {
+            result = 2;
+            break;
+        }
+    }
+    Motor_Set_Chassis_Velocity(0.0f, 0.0f, 0.0f, MOTOR_TRAJ_DRIVER_ACC);
+    return result;
+}
+
+/* ==================== 公开函数 ==================== */
+
+float Motor_Traj_Duration(const MotorWaypoint_t *wp, uint8_t count, uint16_t speed_rpm)
+{
+    float v_max;
+
+    if (speed_rpm == 0) {
+        speed_rpm = MOTOR_XY_DEFAULT_RPM;
+    }
+    v_max = (float)speed_rpm * 3.14159265f * MOTOR_WHEEL_DIAMETER_MM / 60.0f;
+    return traj_plan(wp, count, v_max) ? s_t_end : 0.0f;
+}
+
+uint8_t Motor_Traj_Follow(const MotorWaypoint_t *wp, uint8_t count, uint16_t speed_rpm)
+{
+    TrajYawHold_t hold = { false, 0.0f, 0.0f, 0.0f, 0 };
+
+    return traj_run(wp, count, speed_rpm, &hold);
+}
+
+uint8_t Motor_Traj_Forward_YawHold(float distance_mm, float target_yaw_deg,
+                                   float tolerance_deg, uint16_t speed_rpm)
+{
+    MotorWaypoint_t wp = { distance_mm, 0.0f, 0.0f };
+
+    return yaw_hold_move(&wp, target_yaw_deg, tolerance_deg, speed_rpm);
+}
+
+uint8_t Motor_Traj_Lateral_YawHold(float distance_mm, float target_yaw_deg,
+                                   float tolerance_deg, uint16_t speed_rpm)
+{
+    MotorWaypoint_t wp = { 0.0f, distance_mm, 0.0f };
+
+    return yaw_hold_move(&wp, target_yaw_deg, tolerance_deg, speed_rpm);
+}
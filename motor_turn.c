@@ -0,0 +1,223 @@
+/**
+  ******************************************************************************
+  * @file    motor_turn.c
+  * @brief   原地旋转: DMP航向流 + 预测停车
+  * @details 速度模式匀速旋转, 每周期读取DMP航向并求航向角速度:
+  *          - 起转阶段实测角加速度, 驱动器加减速曲线对称, 以此作为停车减速度
+  *          - 停车角 = 已转角度 + 延迟补偿 + w^2/(2a), 达到目标即下发停车
+  *          - 停稳后仍超出容差才以位置模式补发剩余脉冲, 记为一次修正
+  *          每次旋转的耗时/修正次数/停车误差记录在统计中
+  ******************************************************************************
+  */
+
+#include "motor.h"
+#include "emm_rx.h"
+#include "inv_mpu.h"
+#include <math.h>
+#include <string.h>
+
+/* ==================== 私有类型 ==================== */
+
+typedef struct {
+    float    ref_deg;       // 起始DMP航向
+    float    turned_deg;    // 已转角度 (逆时针为正)
+    float    rate_dps;      // 航向角速度 (滤波后, 度/s)
+    uint32_t tick;          // 最近一次读数时刻
+    uint8_t  fail;          // 连续读取失败次数
+} TurnYaw_t;
+
+/* ==================== 私有变量 ==================== */
+
+static MotorTurnStats_t s_stats;
+
+/* ==================== 私有函数 ==================== */
+
+/**
+ * @brief 驱动器加速度档位对应的车体角加速度 (度/s^2)
+ * @note Emm_V5曲线: 每(256-acc)*50us变化1RPM; 原地旋转时四轮线速度相同
+ */
+static float nominal_alpha(uint8_t acc)
+{
+    const float k_rot = MOTOR_CHASSIS_HALF_L_MM + MOTOR_CHASSIS_HALF_W_MM;
+    float rpm_per_s = 20000.0f / (float)(256 - acc);
+
+    return rpm_per_s * 3.14159265f * MOTOR_WHEEL_DIAMETER_MM / 60.0f / k_rot * 180.0f / 3.14159265f;
+}
+
+/**
+ * @brief 读取一次DMP航向并更新角速度
+ * @return false=本周期无新数据
+ */
+static bool turn_yaw_update(TurnYaw_t *y)
+{
+    float pitch, roll, yaw, turned;
+    uint32_t now = HAL_GetTick();
+
+    if (mpu_dmp_get_data(&pitch, &roll, &yaw) != 0) {
+        if (y->fail < 255U) y->fail++;
+        return false;
+    }
+    y->fail = 0;
+    Motor_Odom_Feed_Yaw(yaw);
+
+    turned = Motor_Get_Rotation_From_Yaw(y->ref_deg, yaw);
+    // 超过180°时Motor_Get_Rotation_From_Yaw会回绕, 按连续角度展开
+    while (turned - y->turned_deg > 180.0f)  turned -= 360.0f;
+    while (turned - y->turned_deg < -180.0f) turned += 360.0f;
+
+    if (now != y->tick) {
+        float rate = (turned - y->turned_deg) * 1000.0f / (float)(now - y->tick);
+        y->rate_dps += MOTOR_TURN_RATE_FILTER * (rate - y->rate_dps);
+    }
+    y->turned_deg = turned;
+    y->tick = now;
+    return true;
+}
+
+/**
+ * @brief 读取一次航向, 失败时每周期重试, 与航向保持运动的容错一致
+ * @return 0=成功, 1=连续失败超过MOTOR_YAW_MAX_READ_FAIL次, 2=等待期间车轮堵转
+ */
+static uint8_t turn_yaw_retry(TurnYaw_t *y)
+{
+    y->fail = 0;
+    while (!turn_yaw_update(y)) {
+        if (y->fail > MOTOR_YAW_MAX_READ_FAIL) {
+            return 1;
+        }
+        if (!Motor_Wait_Until(HAL_GetTick() + MOTOR_TURN_PERIOD_MS)) {
+            return 2;
+        }
+    }
+    return 0;
+}
+
+/* ==================== 公开函数 ==================== */
+
+uint8_t Motor_Rotate_DMP_Predict(float angle_deg, float tolerance_deg, uint16_t speed_rpm)
+{
+    const float k_rot = MOTOR_CHASSIS_HALF_L_MM + MOTOR_CHASSIS_HALF_W_MM;
+    float pitch, roll, sign, target, w_cmd, alpha, err;
+    float t_lo = 0.0f, t_hi = 0.0f;
+    uint32_t t0, tick;
+    TurnYaw_t y;
+    uint8_t result = 0;
+    uint8_t fail = 0;
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    if (speed_rpm == 0) {
+        speed_rpm = MOTOR_XY_DEFAULT_RPM;
+    }
+    while (mpu_dmp_get_data(&pitch, &roll, &y.ref_deg) != 0) {
+        if (++fail > MOTOR_YAW_MAX_READ_FAIL) {
+            return 1;
+        }
+        if (!Motor_Wait_Until(HAL_GetTick() + MOTOR_TURN_PERIOD_MS)) {
+            return 2;
+        }
+    }
+    t0 = tick = HAL_GetTick();
+    y.turned_deg = 0.0f;
+    y.rate_dps = 0.0f;
+    y.tick = t0;
+    y.fail = 0;
+
+    sign = (angle_deg < 0.0f) ? -1.0f : 1.0f;
+    target = fabsf(angle_deg);
+    w_cmd = (float)speed_rpm * 3.14159265f * MOTOR_WHEEL_DIAMETER_MM / 60.0f / k_rot * 180.0f / 3.14159265f;
+    alpha = nominal_alpha(MOTOR_TURN_ACC);
+
+    // 起转并流式读取航向, 预测停车角达到目标时下发停车
+    if (target > tolerance_deg) {
+        Motor_Set_Chassis_Velocity(0.0f, 0.0f, sign * w_cmd, MOTOR_TURN_ACC);
+        while (1) {
+            float turned, rate, stop_at;
+
+            tick += MOTOR_TURN_PERIOD_MS;
+            if (!Motor_Wait_Until(tick)) {
+                result = 2;
+                break;
+            }
+            if (!turn_yaw_update(&y)) {
+                if (y.fail > MOTOR_YAW_MAX_READ_FAIL) {
+                    result = 1;
+                    break;
+                }
+                continue;
+            }
+            turned = sign * y.turned_deg;
+            rate = sign * y.rate_dps;
+
+            // 实测起转角加速度 (20%~80%指令角速度之间)
+            if (t_lo == 0.0f && rate > 0.2f * w_cmd) {
+                t_lo = (float)(y.tick - t0);
+            }
+            if (t_hi == 0.0f && rate > 0.8f * w_cmd && t_lo > 0.0f) {
+                t_hi = (float)(y.tick - t0);
+                if (t_hi > t_lo) {
+                    alpha = 0.6f * w_cmd * 1000.0f / (t_hi - t_lo);
+                }
+            }
+
+            if (rate < 0.0f) rate = 0.0f;
+            stop_at = turned + rate * (MOTOR_TURN_LATENCY_MS + MOTOR_TURN_PERIOD_MS / 2.0f) / 1000.0f
+                    + rate * rate / (2.0f * alpha);
+            if (stop_at >= target) {
+                break;
+            }
+            if (HAL_GetTick() - t0 > MOTOR_TURN_TIMEOUT_MS) {
+                result = 3;
+                break;
+            }
+        }
+        Motor_Set_Chassis_Velocity(0.0f, 0.0f, 0.0f, MOTOR_TURN_ACC);
+    }
+
+    // 等待停稳 (航向角速度回到静止)
+    if (result == 0) {
+        uint32_t settle = HAL_GetTick();
+        do {
+            tick = HAL_GetTick() + MOTOR_TURN_PERIOD_MS;
+            if (!Motor_Wait_Until(tick)) {
+                result = 2;
+                break;
+            }
+            turn_yaw_update(&y);
+        } while (fabsf(y.rate_dps) > MOTOR_TURN_STILL_DPS && HAL_GetTick() - settle < MOTOR_TURN_SETTLE_MS);
+    }
+    s_stats.stop_err_deg = angle_deg - y.turned_deg;
+
+    // 仍超出容差: 位置模式补发剩余角度
+    err = s_stats.stop_err_deg;
+    while (result == 0 && fabsf(err) > tolerance_deg && s_stats.corrections < MOTOR_TURN_MAX_CORRECT) {
+        s_stats.corrections++;
+        if (!Motor_Move_XYTheta(0.0f, 0.0f, err, MOTOR_TURN_CORRECT_RPM)) {
+            break;
+        }
+        if (Motor_Wait_All(MOTOR_MASK_WHEELS, MOTOR_TURN_TIMEOUT_MS) != MOTOR_MASK_WHEELS) {
+            result = (Emm_Rx_Stall_Mask() & MOTOR_MASK_WHEELS) ? 2 : 3;
+            break;
+        }
+        // 等DMP输出追上实际航向, 个别读取失败在下一周期重试
+        tick = HAL_GetTick() + MOTOR_TURN_LATENCY_MS;
+        if (!Motor_Wait_Until(tick)) {
+            result = 2;
+            break;
+        }
+        result = turn_yaw_retry(&y);
+        if (result != 0) {
+            break;
+        }
+        err = angle_deg - y.turned_deg;
+    }
+
+    s_stats.final_err_deg = angle_deg - y.turned_deg;
+    s_stats.alpha_dps2 = alpha;
+    s_stats.time_ms = HAL_GetTick() - t0;
+    return result;
+}
+
+const MotorTurnStats_t *Motor_Get_Turn_Stats(void)
+{
+    return &s_stats;
+}
@@ -2,10 +2,52 @@
 #define __SERVO_H
 
 #include "main.h"
+#include <stdbool.h>
+
+// 舵机编号 (TIM1_CH1~CH3)
+#define SERVO_PAN               0       // 云台
+#define SERVO_CLAW              1       // 爪子
+#define SERVO_AUX               2
+#define SERVO_COUNT             3
+
+#define SERVO_UPDATE_MS         20      // TIM1更新周期 = PWM周期 (ms)
+#define SERVO_RAMP_IRQ_PRIO     5       // TIM1更新中断抢占优先级, 低于电机串口/DMA
+
+// 脉宽标定与转速模型 (servo_ramp.c), 转速/延迟按实测调整
+#define SERVO1_PULSE_MIN_US     500
+#define SERVO1_PULSE_MAX_US     2500
+#define SERVO1_RANGE_DEG        270.0f
+#define SERVO1_SPEED_DPS        300.0f  // 带载转速 (度/s)
+#define SERVO1_LAG_MS           60      // 响应延迟 + 稳定时间 (ms)
+
+#define SERVO2_PULSE_MIN_US     500
+#define SERVO2_PULSE_MAX_US     2500
+#define SERVO2_RANGE_DEG        180.0f
+#define SERVO2_SPEED_DPS        400.0f
+#define SERVO2_LAG_MS           40
+
+#define SERVO3_PULSE_MIN_US     500
+#define SERVO3_PULSE_MAX_US     2500
+#define SERVO3_RANGE_DEG        180.0f
+#define SERVO3_SPEED_DPS        400.0f
+#define SERVO3_LAG_MS           40
 
 void Servo_SetAngle1(float angle);
 void Servo_SetAngle2(float angle);
 void Servo_SetAngle3(float angle);
 
+// 斜坡运动: TIM1更新中断中逐周期改写CCR, 返回预测到位时间(ms)
+// speed_dps<=0或超过实测转速时按实测转速
+// Servo_Ramp_Init在MX_TIM1_Init与PWM通道启动之后调用, 开启TIM1更新中断(NVIC+TIM);
+// 未调用时第一次Servo_Move自动调用. 中断入口TIM1_UP_TIM10_IRQHandler与
+// HAL_TIM_PeriodElapsedCallback分发均在hal_callbacks.c
+void     Servo_Ramp_Init(void);
+uint32_t Servo_Move(uint8_t id, float angle_deg, float speed_dps);
+uint32_t Servo_Predict_ms(uint8_t id, float from_deg, float to_deg, float speed_dps);
+uint32_t Servo_Time_Left_ms(uint8_t id);    // 距预测到位的剩余时间, 0=已到位
+void     Servo_Wait(uint8_t id);
+float    Servo_Get_Angle(uint8_t id);       // 当前斜坡指令角度
+void     Servo_Ramp_Update(void);           // TIM1更新中断中调用
+
 
 #endif
@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file    servo_ramp.c
+  * @brief   舵机斜坡运动与到位时间模型
+  * @details TIM1每个PWM周期(20ms)产生一次更新中断, 舵机也只在每个周期采样一次脉宽,
+  *          因此在更新中断中按步长改写CCR即可得到匀速斜坡:
+  *          - 斜坡速度不超过该舵机的实测转速, 舵机始终能跟上指令
+  *          - 到位时间 = 斜坡时长 + 舵机响应延迟, 调用者按预测时间等待即可
+  *          脉宽换算为CCR时按ARR求计数频率 ((ARR+1)个计数对应SERVO_UPDATE_MS),
+  *          不依赖TIM1预分频恰好为1us/计数
+  ******************************************************************************
+  */
+
+#include "servo.h"
+#include "tim.h"
+#include "motor.h"
+#include <math.h>
+#include <string.h>
+
+/* ==================== 私有类型 ==================== */
+
+typedef struct {
+    uint32_t channel;
+    uint16_t pulse_min_us;      // 0°对应脉宽
+    uint16_t pulse_max_us;      // 满量程对应脉宽
+    float    range_deg;         // 满量程角度
+    float    speed_dps;         // 实测转速 (度/s)
+    uint16_t lag_ms;            // 响应延迟 (含机械稳定)
+} ServoModel_t;
+
+typedef struct {
+    float    cur_deg;           // 当前指令角度 (斜坡中间值)
+    float    target_deg;
+    float    step_deg;          // 每个更新周期的角度步长
+    uint32_t arrive_tick;       // 预测到位时刻 (HAL_GetTick)
+    bool     valid;             // 已有过指令, cur_deg可信
+} ServoState_t;
+
+/* ==================== 私有变量 ==================== */
+
+static const ServoModel_t s_model[SERVO_COUNT] = {
+    { TIM_CHANNEL_1, SERVO1_PULSE_MIN_US, SERVO1_PULSE_MAX_US, SERVO1_RANGE_DEG, SERVO1_SPEED_DPS, SERVO1_LAG_MS },
+    { TIM_CHANNEL_2, SERVO2_PULSE_MIN_US, SERVO2_PULSE_MAX_US, SERVO2_RANGE_DEG, SERVO2_SPEED_DPS, SERVO2_LAG_MS },
+    { TIM_CHANNEL_3, SERVO3_PULSE_MIN_US, SERVO3_PULSE_MAX_US, SERVO3_RANGE_DEG, SERVO3_SPEED_DPS, SERVO3_LAG_MS },
+};
+
+static ServoState_t s_servo[SERVO_COUNT];
+static bool         s_ramp_init = false;
+
+/* ==================== 私有函数 ==================== */
+
+static void write_ccr(uint8_t id, float angle_deg)
+{
+    const ServoModel_t *m = &s_model[id];
+    float ticks_per_us = (float)(__HAL_TIM_GET_AUTORELOAD(&htim1) + 1U) / (SERVO_UPDATE_MS * 1000.0f);
+    float pulse = (float)m->pulse_min_us +
+                  angle_deg / m->range_deg * (float)(m->pulse_max_us - m->pulse_min_us);
+
+    __HAL_TIM_SET_COMPARE(&htim1, m->channel, (uint32_t)lroundf(pulse * ticks_per_us));
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Servo_Ramp_Init(void)
+{
+    memset(s_servo, 0, sizeof(s_servo));
+    HAL_NVIC_SetPriority(TIM1_UP_TIM10_IRQn, SERVO_RAMP_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(TIM1_UP_TIM10_IRQn);
+    HAL_TIM_Base_Start_IT(&htim1);
+    s_ramp_init = true;
+}
+
+uint32_t Servo_Predict_ms(uint8_t id, float from_deg, float to_deg, float speed_dps)
+{
+    const ServoModel_t *m;
+    float dist;
+
+    if (id >= SERVO_COUNT) {
+        return 0;
+    }
+    m = &s_model[id];
+    if (speed_dps <= 0.0f || speed_dps > m->speed_dps) {
+        speed_dps = m->speed_dps;
+    }
+    dist = fabsf(to_deg - from_deg);
+    if (dist < 0.01f) {
+        return 0;
+    }
+    // 斜坡按更新周期取整 + 舵机响应延迟
+    return (uint32_t)(ceilf(dist / speed_dps * 1000.0f / SERVO_UPDATE_MS) * SERVO_UPDATE_MS) + m->lag_ms;
+}
+
+uint32_t Servo_Move(uint8_t id, float angle_deg, float speed_dps)
+{
+    const ServoModel_t *m;
+    ServoState_t *s;
+    uint32_t t_ms;
+    float dist;
+
+    if (id >= SERVO_COUNT) {
+        return 0;
+    }
+    if (!s_ramp_init) {
+        Servo_Ramp_Init();
+    }
+    m = &s_model[id];
+    s = &s_servo[id];
+    if (angle_deg < 0.0f) angle_deg = 0.0f;
+    if (angle_deg > m->range_deg) angle_deg = m->range_deg;
+    if (speed_dps <= 0.0f || speed_dps > m->speed_dps) {
+        speed_dps = m->speed_dps;
+    }
+
+    __disable_irq();
+    if (!s->valid) {
+        // 上电后首次指令: 舵机位置未知, 直接跳变并按满量程估计到位时间
+        s->cur_deg = angle_deg;
+        s->target_deg = angle_deg;
+        s->step_deg = 0.0f;
+        s->valid = true;
+        write_ccr(id, angle_deg);
+        __enable_irq();
+        t_ms = Servo_Predict_ms(id, 0.0f, m->range_deg, 0.0f);
+        s->arrive_tick = HAL_GetTick() + t_ms;
+        return t_ms;
+    }
+    dist = fabsf(angle_deg - s->cur_deg);
+    s->target_deg = angle_deg;
+    s->step_deg = speed_dps * SERVO_UPDATE_MS / 1000.0f;
+    __enable_irq();
+
+    t_ms = Servo_Predict_ms(id, 0.0f, dist, speed_dps);
+    s->arrive_tick = HAL_GetTick() + t_ms;
+    return t_ms;
+}
+
+uint32_t Servo_Time_Left_ms(uint8_t id)
+{
+    int32_t left;
+
+    if (id >= SERVO_COUNT) {
+        return 0;
+    }
+    left = (int32_t)(s_servo[id].arrive_tick - HAL_GetTick());
+    return (left > 0) ? (uint32_t)left : 0U;
+}
+
+void Servo_Wait(uint8_t id)
+{
+    while (Servo_Time_Left_ms(id) > 0) {
+        Motor_Background_Process();
+    }
+}
+
+float Servo_Get_Angle(uint8_t id)
+{
+    return (id < SERVO_COUNT) ? s_servo[id].cur_deg : 0.0f;
+}
+
+void Servo_Ramp_Update(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < SERVO_COUNT; i++) {
+        ServoState_t *s = &s_servo[i];
+        float d = s->target_deg - s->cur_deg;
+
+        if (d == 0.0f) {
+            continue;
+        }
+        if (fabsf(d) <= s->step_deg) {
+            s->cur_deg = s->target_deg;
+        } else {
+            s->cur_deg += (d > 0.0f) ? s->step_deg : -s->step_deg;
+        }
+        write_ccr(i, s->cur_deg);
+    }
+}
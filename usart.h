@@ -44,6 +44,9 @@ extern UART_HandleTypeDef huart3;
 
 #define		CMD_LEN		255
 
+// Emm_V5回复旧接口: 由emm_rx.c解析出完整帧后同步更新
+// 新代码请使用Emm_Rx_Get()按驱动器地址读取, 避免多电机回复互相覆盖
+
 extern __IO bool rxFrameFlag;
 extern __IO uint8_t rxCmd[CMD_LEN];
 extern __IO uint8_t rxCount;
@@ -0,0 +1,359 @@
+/**
+  ******************************************************************************
+  * @file    visual_calib.c
+  * @brief   像素 -> 车体位移标定实现
+  * @details 标定: 从正对位置出发走3x3网格 (步长VCAL_STEP_MM), 每点停稳后平均
+  *          VCAL_SAMPLES帧. 车体位移(X, Y)与目标像素(x, y)满足
+  *          X = a00*x + a01*y + b0, Y = a10*x + a11*y + b1,
+  *          像素去均值后截距与斜率解耦, 每行只需解2x2正规方程.
+  *          起点处 (X, Y) = (0, 0), 对应像素即对位目标像素, 因此所需位移为 a * (s - p).
+  *          结果按目标类型存入Flash扇区, 整条记录带CRC16, 上电后首次使用时载入;
+  *          写Flash会使CPU停顿, 由Visual_Calib_Save单独完成, 不在标定过程中进行
+  ******************************************************************************
+  */
+
+#include "visual_calib.h"
+#include "visual_servo.h"
+#include "motor.h"
+#include "emm_rx.h"
+#include "crc16.h"
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+/* ==================== 私有类型 ==================== */
+
+#define VCAL_REC_MAGIC      0x4C414356UL    // "VCAL"
+#define VCAL_REC_VERSION    1
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t valid;         // 位i=1: TargetType_t i 已标定
+    VisualCalib_t cal[VCAL_TARGET_COUNT];
+    uint16_t crc;           // 以上字段的CRC16
+    uint16_t reserved;      // 补齐到字, 按字写入Flash
+} VCalRecord_t;
+
+/* ==================== 私有变量 ==================== */
+
+static VCalRecord_t s_rec;                  // RAM副本
+static bool s_loaded = false;
+
+// 标定网格 (mm, 相对起点), 依次访问后回到起点
+static const int8_t s_grid[][2] = {
+    { 0,  0}, { 1,  0}, { 1,  1}, { 0,  1}, {-1,  1},
+    {-1,  0}, {-1, -1}, { 0, -1}, { 1, -1}
+};
+#define VCAL_GRID_POINTS    (sizeof(s_grid) / sizeof(s_grid[0]))
+
+#ifndef HOST_BUILD
+extern uint32_t _sidata, _sdata, _edata;    // 链接脚本符号: .data初值在Flash中的位置与RAM中的范围
+#endif
+
+/* ==================== 私有函数 ==================== */
+
+/**
+ * @brief 标定扇区是否可用: 芯片Flash须有1MB (扇区11存在), 且程序映像未延伸进该扇区
+ * @note 链接脚本已按文件头说明缩小程序区时后一条恒成立, 此处防止未修改链接脚本的固件擦掉自身
+ */
+static bool flash_region_ok(void)
+{
+    uint32_t flash_kb = *(const uint16_t *)FLASHSIZE_BASE;
+
+    if (flash_kb * 1024U < VCAL_FLASH_OFFSET + VCAL_FLASH_SIZE) {
+        return false;
+    }
+#ifndef HOST_BUILD
+    // 程序映像末端 = .data初值末端 (位于.text/.rodata之后)
+    if ((uint32_t)&_sidata + ((uint32_t)&_edata - (uint32_t)&_sdata) > VCAL_FLASH_ADDR) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+static void rec_load(void)
+{
+    const VCalRecord_t *flash = (const VCalRecord_t *)VCAL_FLASH_ADDR;
+
+    if (s_loaded) {
+        return;
+    }
+    if (flash_region_ok() &&
+        flash->magic == VCAL_REC_MAGIC && flash->version == VCAL_REC_VERSION &&
+        flash->crc == Crc16_Calc((const uint8_t *)flash, (uint16_t)offsetof(VCalRecord_t, crc))) {
+        memcpy(&s_rec, flash, sizeof(s_rec));
+    } else {
+        memset(&s_rec, 0, sizeof(s_rec));
+    }
+    s_loaded = true;
+}
+
+/**
+ * @brief RAM副本写入Flash (擦除整个扇区后按字编程)
+ */
+static bool rec_store(void)
+{
+    FLASH_EraseInitTypeDef erase;
+    const uint32_t *src = (const uint32_t *)&s_rec;
+    uint32_t i, sector_error = 0;
+    bool ok;
+
+    s_rec.magic = VCAL_REC_MAGIC;
+    s_rec.version = VCAL_REC_VERSION;
+    s_rec.reserved = 0xFFFF;
+    s_rec.crc = Crc16_Calc((const uint8_t *)&s_rec, (uint16_t)offsetof(VCalRecord_t, crc));
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Banks = FLASH_BANK_1;
+    erase.Sector = VCAL_FLASH_SECTOR;
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+    HAL_FLASH_Unlock();
+    ok = HAL_FLASHEx_Erase(&erase, &sector_error) == HAL_OK;
+    for (i = 0; ok && i < sizeof(s_rec) / 4U; i++) {
+        ok = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, VCAL_FLASH_ADDR + i * 4U, src[i]) == HAL_OK;
+    }
+    HAL_FLASH_Lock();
+
+    return ok && memcmp((const void *)VCAL_FLASH_ADDR, &s_rec, sizeof(s_rec)) == 0;
+}
+
+static VisualTask_t target_task(TargetType_t type)
+{
+    switch (type) {
+        case TARGET_TEST_PLATFORM: return TASK_PLATFORM;
+        case TARGET_ASSEMBLY_SLOT: return TASK_SLOT;
+        default:                   return TASK_IDENTIFY_MATERIAL;
+    }
+}
+
+/**
+ * @brief 相对移动并等待到位
+ * @return false=发送失败/超时/堵转
+ */
+static bool move_rel(float dx_mm, float dy_mm)
+{
+    if (dx_mm == 0.0f && dy_mm == 0.0f) {
+        return true;
+    }
+    if (!Motor_Move_XYTheta(dx_mm, dy_mm, 0.0f, VCAL_SPEED_RPM)) {
+        return false;
+    }
+    return Motor_Wait_All(MOTOR_MASK_WHEELS, VCAL_MOVE_TIMEOUT_MS) == MOTOR_MASK_WHEELS;
+}
+
+/**
+ * @brief 采集n帧检测到目标的帧并取平均, 只使用after之后采集且属于推流目标的帧
+ * @return false=超时或一直未检测到目标
+ */
+static bool sample(uint32_t after, uint8_t n, float *x, float *y)
+{
+    VisualFrame_t f;
+    uint32_t count, tickstart = HAL_GetTick();
+    float sx = 0.0f, sy = 0.0f;
+    uint8_t got = 0;
+
+    Visual_Stream_Get(&f);
+    count = f.count;
+    while (got < n) {
+        if (HAL_GetTick() - tickstart > VCAL_FRAME_TIMEOUT_MS * (uint32_t)(n + 1U) ||
+            !Visual_Stream_Wait_Newer(count, VCAL_FRAME_TIMEOUT_MS, &f)) {
+            return false;
+        }
+        count = f.count;
+        if (!Visual_Stream_Frame_Matches(&f) || !f.found || (int32_t)(f.capture_tick - after) < 0) {
+            continue;
+        }
+        sx += f.x;
+        sy += f.y;
+        got++;
+    }
+    *x = sx / n;
+    *y = sy / n;
+    return true;
+}
+
+/**
+ * @brief 停稳后采样: 采集时刻晚于 当前+VCAL_SETTLE_MS 的帧才有效
+ */
+static bool sample_settled(uint8_t n, float *x, float *y)
+{
+    return sample(HAL_GetTick() + VCAL_SETTLE_MS, n, x, y);
+}
+
+/**
+ * @brief 最小二乘拟合 X = a*p + b, 结果写入cal->a, 返回残差
+ * @param px/py 各网格点像素, X/Y 各网格点车体位移
+ * @return false=像素跨度不足或矩阵奇异
+ */
+static bool fit(const float *px, const float *py, const float *X, const float *Y,
+                uint8_t n, VisualCalib_t *cal)
+{
+    float mx = 0, my = 0, mX = 0, mY = 0;
+    float sxx = 0, syy = 0, sxy = 0, sxX = 0, syX = 0, sxY = 0, syY = 0, det, err = 0;
+    uint8_t i;
+
+    for (i = 0; i < n; i++) {
+        mx += px[i]; my += py[i]; mX += X[i]; mY += Y[i];
+    }
+    mx /= n; my /= n; mX /= n; mY /= n;
+
+    for (i = 0; i < n; i++) {
+        float dx = px[i] - mx, dy = py[i] - my;
+
+        sxx += dx * dx; syy += dy * dy; sxy += dx * dy;
+        sxX += dx * (X[i] - mX); syX += dy * (X[i] - mX);
+        sxY += dx * (Y[i] - mY); syY += dy * (Y[i] - mY);
+    }
+    if (sqrtf(sxx / n) < VCAL_MIN_SPAN_PX * 0.5f || sqrtf(syy / n) < VCAL_MIN_SPAN_PX * 0.5f) {
+        return false;
+    }
+    det = sxx * syy - sxy * sxy;
+    if (fabsf(det) < 1e-6f * sxx * syy) {
+        return false;
+    }
+    cal->a[0][0] = (sxX * syy - syX * sxy) / det;
+    cal->a[0][1] = (syX * sxx - sxX * sxy) / det;
+    cal->a[1][0] = (sxY * syy - syY * sxy) / det;
+    cal->a[1][1] = (syY * sxx - sxY * sxy) / det;
+
+    for (i = 0; i < n; i++) {
+        float ex = mX + cal->a[0][0] * (px[i] - mx) + cal->a[0][1] * (py[i] - my) - X[i];
+        float ey = mY + cal->a[1][0] * (px[i] - mx) + cal->a[1][1] * (py[i] - my) - Y[i];
+
+        err += ex * ex + ey * ey;
+    }
+    cal->rms_mm = sqrtf(err / n);
+    return true;
+}
+
+/* ==================== 公开函数 ==================== */
+
+uint8_t Visual_Calib_Run(TargetType_t target_type, ColorTarget_t color)
+{
+    float px[VCAL_GRID_POINTS], py[VCAL_GRID_POINTS], X[VCAL_GRID_POINTS], Y[VCAL_GRID_POINTS];
+    float cur_x = 0.0f, cur_y = 0.0f;
+    VisualCalib_t cal;
+    uint8_t i, result = 0;
+
+    if ((uint32_t)target_type >= VCAL_TARGET_COUNT) {
+        return 3;
+    }
+    rec_load();
+    Visual_Stream_Start(target_task(target_type), (uint8_t)color, VSERVO_FPS);
+
+    for (i = 0; i < VCAL_GRID_POINTS; i++) {
+        X[i] = s_grid[i][0] * VCAL_STEP_MM;
+        Y[i] = s_grid[i][1] * VCAL_STEP_MM;
+        if (!move_rel(X[i] - cur_x, Y[i] - cur_y)) {
+            result = 2;
+            break;
+        }
+        cur_x = X[i];
+        cur_y = Y[i];
+        if (!sample_settled(VCAL_SAMPLES, &px[i], &py[i])) {
+            result = 1;
+            break;
+        }
+    }
+
+    Visual_Stream_Stop();
+    // 回到起点; 堵转时不再尝试
+    if (result != 2 && !move_rel(-cur_x, -cur_y)) {
+        result = 2;
+    }
+    if (result != 0) {
+        return result;
+    }
+
+    // 偏离正对位置(X, Y)时看到像素p, 则 (X, Y) = a * (p - s), 回到正对位置需移动 a * (s - p)
+    cal.sx = px[0];
+    cal.sy = py[0];
+    if (!fit(px, py, X, Y, (uint8_t)VCAL_GRID_POINTS, &cal) || cal.rms_mm > VCAL_MAX_RMS_MM) {
+        return 3;
+    }
+
+    s_rec.cal[target_type] = cal;
+    s_rec.valid |= (uint16_t)(1U << target_type);
+    return 0;
+}
+
+uint8_t Visual_Calib_Save(void)
+{
+    if (!flash_region_ok()) {
+        return 1;
+    }
+    if (Visual_Stream_Active()) {
+        return 2;
+    }
+    rec_load();
+    return rec_store() ? 0 : 3;
+}
+
+bool Visual_Calib_Get(TargetType_t target_type, VisualCalib_t *out)
+{
+    if ((uint32_t)target_type >= VCAL_TARGET_COUNT) {
+        return false;
+    }
+    rec_load();
+    if (!(s_rec.valid & (1U << target_type))) {
+        return false;
+    }
+    *out = s_rec.cal[target_type];
+    return true;
+}
+
+bool Visual_Calib_Map(TargetType_t target_type, float x_px, float y_px, float *dx_mm, float *dy_mm)
+{
+    VisualCalib_t cal;
+
+    if (!Visual_Calib_Get(target_type, &cal)) {
+        return false;
+    }
+    *dx_mm = cal.a[0][0] * (cal.sx - x_px) + cal.a[0][1] * (cal.sy - y_px);
+    *dy_mm = cal.a[1][0] * (cal.sx - x_px) + cal.a[1][1] * (cal.sy - y_px);
+    return true;
+}
+
+uint8_t Visual_Calib_Align(TargetType_t target_type, ColorTarget_t color, uint8_t *moves)
+{
+    VisualCalib_t cal;
+    float x, y, dx, dy;
+    uint8_t n = 0, result;
+
+    if (!Visual_Calib_Get(target_type, &cal)) {
+        return 1;
+    }
+    Visual_Stream_Start(target_task(target_type), (uint8_t)color, VSERVO_FPS);
+
+    while (1) {
+        // 车体静止: 第一帧用于求位移; 移动后须停稳再取一帧确认
+        if (!sample(HAL_GetTick() + (n > 0 ? VCAL_SETTLE_MS : 0U), 1, &x, &y)) {
+            result = 2;
+            break;
+        }
+        if (fabsf(x - cal.sx) <= VSERVO_TOL_PX && fabsf(y - cal.sy) <= VSERVO_TOL_PX) {
+            result = 0;
+            break;
+        }
+        if (n >= VCAL_MAX_MOVES) {
+            result = 4;
+            break;
+        }
+        Visual_Calib_Map(target_type, x, y, &dx, &dy);
+        n++;
+        if (!move_rel(dx, dy)) {
+            result = 3;
+            break;
+        }
+    }
+
+    Visual_Stream_Stop();
+    if (moves != NULL) {
+        *moves = n;
+    }
+    return result;
+}
@@ -0,0 +1,99 @@
+/**
+  ******************************************************************************
+  * @file    visual_calib.h
+  * @brief   像素 -> 车体位移标定头文件
+  * @details 每种对位目标(TargetType_t)独立标定, 结果保存在Flash:
+  *          - 标定前把车体摆到正对目标的位置, 该处实测像素坐标即为对位目标像素
+  *          - 以Motor_Move_XYTheta走过已知位移网格, 记录各点的目标像素坐标
+  *          - 最小二乘拟合仿射映射: 车体位移 = A * 像素 + b
+  *            (相机近似俯视、目标在同一平面内, 仿射即可描述缩放/旋转/错切)
+  *          对位时由一帧像素误差直接求出所需位移, 一次XY运动到位, 再以一帧确认
+  *
+  *          Flash存储占用扇区11 (0x080E0000~0x080FFFFF), 仅1MB型号存在该扇区.
+  *          链接脚本须把程序区缩小到前896KB, 否则程序增长后会被标定擦除覆盖:
+  *            FLASH (rx) : ORIGIN = 0x8000000, LENGTH = 896K
+  *          运行时另行检查芯片Flash容量与程序映像末端, 不满足时不读写该扇区
+  ******************************************************************************
+  */
+
+#ifndef __VISUAL_CALIB_H
+#define __VISUAL_CALIB_H
+
+#include "visual_stream.h"
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+// Flash存储位置: 扇区11 (128KB), 链接脚本须将该扇区排除在程序区之外 (见文件头)
+#define VCAL_FLASH_SECTOR       FLASH_SECTOR_11
+#define VCAL_FLASH_OFFSET       0xE0000U                        // 扇区11相对FLASH_BASE的偏移
+#define VCAL_FLASH_SIZE         0x20000U                        // 扇区11大小
+#define VCAL_FLASH_ADDR         (FLASH_BASE + VCAL_FLASH_OFFSET)
+
+#define VCAL_TARGET_COUNT       3       // TargetType_t 取值数
+#define VCAL_STEP_MM            20.0f   // 标定网格步长 (mm), 3x3网格
+#define VCAL_SAMPLES            5       // 每个网格点平均的帧数
+#define VCAL_SPEED_RPM          20      // 标定移动速度 (RPM)
+#define VCAL_SETTLE_MS          100     // 到位后再等待此时间才采集的帧才有效 (ms)
+#define VCAL_MOVE_TIMEOUT_MS    3000    // 单次移动超时 (ms)
+#define VCAL_FRAME_TIMEOUT_MS   500     // 等待单帧超时 (ms)
+#define VCAL_MIN_SPAN_PX        10.0f   // 网格在图像中的最小跨度, 过小说明目标未随车体移动
+#define VCAL_MAX_RMS_MM         1.5f    // 拟合残差上限 (mm)
+#define VCAL_MAX_MOVES          2       // 对位最多移动次数 (正常一次即到位)
+
+/* ==================== 类型定义 ==================== */
+
+/**
+ * @brief 单种目标的标定结果
+ */
+typedef struct {
+    float sx;               // 对位目标像素坐标
+    float sy;
+    float a[2][2];          // [前进mm; 右移mm] = a * [sx - x; sy - y]
+    float rms_mm;           // 拟合残差
+} VisualCalib_t;
+
+/* ==================== 公开函数声明 ==================== */
+
+/**
+ * @brief 标定一种目标, 结果只更新RAM副本 (立即生效), 掉电保存需再调用Visual_Calib_Save
+ * @param target_type 目标类型
+ * @param color 目标颜色
+ * @return 0=成功, 1=未收到目标帧, 2=移动失败/堵转, 3=拟合失败
+ * @note 调用前车体须正对目标; 标定结束后回到起点
+ */
+uint8_t Visual_Calib_Run(TargetType_t target_type, ColorTarget_t color);
+
+/**
+ * @brief 把全部标定结果写入Flash
+ * @return 0=成功, 1=扇区不可用(Flash不足1MB或程序映像已进入扇区11), 2=推流进行中, 3=擦写/校验失败
+ * @note 单Bank的F4擦除扇区期间CPU无法从Flash取指, 约1~2s内主循环与所有中断(含SysTick)
+ *       全部停顿, 电机总线发送队列也不会推进. 只能在车体静止、无运动命令待发时调用,
+ *       不得在任务流程中调用; HAL_GetTick会少计停顿时间
+ */
+uint8_t Visual_Calib_Save(void);
+
+/**
+ * @brief 读取标定结果
+ * @return false=该目标未标定
+ */
+bool Visual_Calib_Get(TargetType_t target_type, VisualCalib_t *out);
+
+/**
+ * @brief 以标定结果把目标像素坐标换算为所需车体位移
+ * @param dx_mm 输出: 车体需前进的距离
+ * @param dy_mm 输出: 车体需右移的距离
+ * @return false=该目标未标定, 输出不变
+ */
+bool Visual_Calib_Map(TargetType_t target_type, float x_px, float y_px, float *dx_mm, float *dy_mm);
+
+/**
+ * @brief 按标定结果一次移动完成对位, 再以一帧确认
+ * @param target_type 目标类型
+ * @param color 目标颜色
+ * @param moves 输出实际移动次数, 可为NULL
+ * @return 0=对位完成, 1=未标定, 2=未收到目标帧, 3=移动失败/堵转, 4=移动VCAL_MAX_MOVES次仍超差
+ */
+uint8_t Visual_Calib_Align(TargetType_t target_type, ColorTarget_t color, uint8_t *moves);
+
+#endif /* __VISUAL_CALIB_H */
@@ -0,0 +1,241 @@
+/**
+  ******************************************************************************
+  * @file    visual_servo.c
+  * @brief   视觉伺服对位实现
+  * @details 每个控制周期:
+  *          - 有新帧时以其像素坐标求采集时刻的位移误差
+  *          - 误差减去采集时刻之后已下发速度的积分, 得到当前误差的估计 (延迟补偿)
+  *          - 比例增益随误差从KP_FAR过渡到KP_NEAR, 积分仅在小误差区生效, 消除静差
+  *          - 速度与速度变化率限幅后以速度模式下发
+  ******************************************************************************
+  */
+
+#include "visual_servo.h"
+#include "visual_calib.h"
+#include "motor.h"
+#include <math.h>
+#include <string.h>
+
+/* ==================== 私有类型 ==================== */
+
+typedef struct {
+    uint32_t tick;          // 生效时刻
+    float    vx;            // 前进速度 (mm/s)
+    float    vy;            // 右移速度 (mm/s)
+} VServoCmd_t;
+
+/* ==================== 私有变量 ==================== */
+
+static VServoCmd_t s_hist[VSERVO_HIST_SIZE];
+static uint8_t     s_hist_head = 0;         // 最新一条的下标
+static uint8_t     s_hist_count = 0;
+static VisualServoStats_t s_stats;
+
+/* ==================== 私有函数 ==================== */
+
+static void target_setpoint(TargetType_t type, float *sx, float *sy)
+{
+    VisualCalib_t cal;
+
+    if (Visual_Calib_Get(type, &cal)) {
+        *sx = cal.sx;
+        *sy = cal.sy;
+        return;
+    }
+    switch (type) {
+        case TARGET_TEST_PLATFORM: *sx = VSERVO_PLATFORM_X_PX; *sy = VSERVO_PLATFORM_Y_PX; break;
+        case TARGET_ASSEMBLY_SLOT: *sx = VSERVO_SLOT_X_PX;     *sy = VSERVO_SLOT_Y_PX;     break;
+        default:                   *sx = VSERVO_BLOCK_X_PX;    *sy = VSERVO_BLOCK_Y_PX;    break;
+    }
+}
+
+static void hist_push(uint32_t tick, float vx, float vy)
+{
+    s_hist_head = (uint8_t)((s_hist_head + 1U) % VSERVO_HIST_SIZE);
+    s_hist[s_hist_head].tick = tick;
+    s_hist[s_hist_head].vx = vx;
+    s_hist[s_hist_head].vy = vy;
+    if (s_hist_count < VSERVO_HIST_SIZE) {
+        s_hist_count++;
+    }
+}
+
+/**
+ * @brief [since, now) 内已下发速度对应的位移
+ */
+static void hist_moved(uint32_t since, uint32_t now, float *dx, float *dy)
+{
+    uint32_t end = now;
+    uint8_t i, k = s_hist_head;
+
+    *dx = 0.0f;
+    *dy = 0.0f;
+    for (i = 0; i < s_hist_count; i++) {
+        const VServoCmd_t *c = &s_hist[k];
+        uint32_t start = ((int32_t)(c->tick - since) > 0) ? c->tick : since;
+
+        if ((int32_t)(end - start) > 0) {
+            *dx += c->vx * (float)(end - start) / 1000.0f;
+            *dy += c->vy * (float)(end - start) / 1000.0f;
+        }
+        if ((int32_t)(c->tick - since) <= 0) {
+            break;
+        }
+        end = c->tick;
+        k = (uint8_t)((k + VSERVO_HIST_SIZE - 1U) % VSERVO_HIST_SIZE);
+    }
+}
+
+/**
+ * @brief 向量限幅
+ */
+static void limit_vec(float *x, float *y, float max)
+{
+    float n = sqrtf(*x * *x + *y * *y);
+
+    if (n > max && n > 0.0f) {
+        *x *= max / n;
+        *y *= max / n;
+    }
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Visual_Servo_Pixel_To_Chassis(TargetType_t target_type, float x_px, float y_px,
+                                   float *dx_mm, float *dy_mm)
+{
+    float sx, sy, k;
+
+    // 已标定时使用标定的仿射映射, 否则按安装参数估算
+    if (Visual_Calib_Map(target_type, x_px, y_px, dx_mm, dy_mm)) {
+        return;
+    }
+    target_setpoint(target_type, &sx, &sy);
+    switch (target_type) {
+        case TARGET_TEST_PLATFORM: k = VSERVO_PLATFORM_MM_PER_PX; break;
+        case TARGET_ASSEMBLY_SLOT: k = VSERVO_SLOT_MM_PER_PX;     break;
+        default:                   k = VSERVO_BLOCK_MM_PER_PX;    break;
+    }
+    *dx_mm = (float)VSERVO_IMG_Y_TO_FWD * (y_px - sy) * k;
+    *dy_mm = (float)VSERVO_IMG_X_TO_RIGHT * (x_px - sx) * k;
+}
+
+VisualServoResult_t Visual_Servo_Align(TargetType_t target_type, ColorTarget_t color)
+{
+    const float dt = VSERVO_PERIOD_MS / 1000.0f;
+    VisualServoResult_t result;
+    VisualTask_t task;
+    VisualFrame_t f;
+    uint32_t t0, tick, now, last_count, last_seen = 0, cap_tick = 0, lat_sum = 0;
+    float sx, sy, ex_cap = 0.0f, ey_cap = 0.0f;
+    float vx = 0.0f, vy = 0.0f, ix = 0.0f, iy = 0.0f;
+    uint8_t in_tol = 0;
+    bool have = false;
+
+    switch (target_type) {
+        case TARGET_TEST_PLATFORM: task = TASK_PLATFORM;          break;
+        case TARGET_ASSEMBLY_SLOT: task = TASK_SLOT;              break;
+        default:                   task = TASK_IDENTIFY_MATERIAL; break;
+    }
+    target_setpoint(target_type, &sx, &sy);
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_hist_count = 0;
+
+    Visual_Stream_Get(&f);
+    last_count = f.count;           // 只使用推流开始之后的帧
+    Visual_Stream_Start(task, (uint8_t)color, VSERVO_FPS);
+    t0 = tick = HAL_GetTick();
+    hist_push(t0, 0.0f, 0.0f);
+
+    while (1) {
+        float ux = 0.0f, uy = 0.0f, dvx, dvy;
+
+        tick += VSERVO_PERIOD_MS;
+        if (!Motor_Wait_Until(tick)) {
+            result = VSERVO_STALL;
+            break;
+        }
+        now = HAL_GetTick();
+
+        // 新帧: 更新采集时刻的误差, 以实测像素误差判定完成
+        if (Visual_Stream_Get(&f) && f.count != last_count) {
+            last_count = f.count;
+            if (!Visual_Stream_Frame_Matches(&f)) {
+                s_stats.rejected++;         // 其他目标的结果, 不能用来驱动底盘
+            } else if (f.found) {
+                Visual_Servo_Pixel_To_Chassis(target_type, f.x, f.y, &ex_cap, &ey_cap);
+                cap_tick = f.capture_tick;
+                last_seen = now;
+                have = true;
+                s_stats.frames++;
+                lat_sum += now - f.capture_tick;
+                if (fabsf((float)f.x - sx) <= VSERVO_TOL_PX && fabsf((float)f.y - sy) <= VSERVO_TOL_PX) {
+                    in_tol++;
+                } else {
+                    in_tol = 0;
+                }
+                if (in_tol >= VSERVO_DONE_FRAMES) {
+                    result = VSERVO_OK;
+                    break;
+                }
+            }
+        }
+        if (!have && now - t0 > VSERVO_LOST_MS * 3U) {
+            result = VSERVO_NO_STREAM;
+            break;
+        }
+        if (have && now - last_seen > VSERVO_LOST_MS) {
+            result = VSERVO_LOST;
+            break;
+        }
+        if (now - t0 > VSERVO_TIMEOUT_MS) {
+            result = VSERVO_TIMEOUT;
+            break;
+        }
+
+        if (have) {
+            float mx, my, ex, ey, e, kp;
+
+            // 延迟补偿: 采集之后已走过的位移不再计入误差
+            hist_moved(cap_tick, now, &mx, &my);
+            ex = ex_cap - mx;
+            ey = ey_cap - my;
+            e = sqrtf(ex * ex + ey * ey);
+
+            kp = VSERVO_KP_NEAR + (VSERVO_KP_FAR - VSERVO_KP_NEAR) * fminf(e / VSERVO_SCHED_MM, 1.0f);
+            if (e < VSERVO_I_ZONE_MM) {
+                ix += VSERVO_KI * ex * dt;
+                iy += VSERVO_KI * ey * dt;
+                limit_vec(&ix, &iy, VSERVO_I_LIMIT_MM_S);
+            } else {
+                ix = 0.0f;
+                iy = 0.0f;
+            }
+            ux = kp * ex + ix;
+            uy = kp * ey + iy;
+            limit_vec(&ux, &uy, VSERVO_V_MAX_MM_S);
+        }
+
+        dvx = ux - vx;
+        dvy = uy - vy;
+        limit_vec(&dvx, &dvy, VSERVO_ACC_MM_S2 * dt);
+        vx += dvx;
+        vy += dvy;
+        Motor_Set_Chassis_Velocity(vx, vy, 0.0f, MOTOR_TRAJ_DRIVER_ACC);
+        hist_push(now, vx, vy);
+    }
+
+    Motor_Set_Chassis_Velocity(0.0f, 0.0f, 0.0f, MOTOR_TRAJ_DRIVER_ACC);
+    Visual_Stream_Stop();
+
+    s_stats.time_ms = HAL_GetTick() - t0;
+    s_stats.err_x_mm = ex_cap;
+    s_stats.err_y_mm = ey_cap;
+    s_stats.latency_ms = s_stats.frames ? (uint16_t)(lat_sum / s_stats.frames) : 0U;
+    return result;
+}
+
+const VisualServoStats_t *Visual_Servo_Get_Stats(void)
+{
+    return &s_stats;
+}
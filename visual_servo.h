@@ -0,0 +1,103 @@
+/**
+  ******************************************************************************
+  * @file    visual_servo.h
+  * @brief   视觉伺服对位头文件
+  * @details 以推流帧的像素误差连续驱动底盘速度模式, 一次平滑接近完成对位:
+  *          - 像素误差换算为车体系位移误差, 增益随误差大小调度的PI控制律
+  *          - 按帧的采集时刻做延迟补偿: 扣除采集之后已下发的速度所对应的位移
+  *          - 实测误差连续VSERVO_DONE_FRAMES帧在容差内即停车完成
+  *          物块/凸台/凹槽共用同一控制器, 仅目标像素与换算比例不同
+  ******************************************************************************
+  */
+
+#ifndef __VISUAL_SERVO_H
+#define __VISUAL_SERVO_H
+
+#include "visual_stream.h"
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+// 对位目标像素坐标: 机械爪正对目标时目标中心在图像中的位置 (按实际安装估算)
+// 以下像素坐标与换算比例仅在该目标未经Visual_Calib_Run标定时使用
+#define VSERVO_BLOCK_X_PX           320
+#define VSERVO_BLOCK_Y_PX           240
+#define VSERVO_PLATFORM_X_PX        320
+#define VSERVO_PLATFORM_Y_PX        240
+#define VSERVO_SLOT_X_PX            320
+#define VSERVO_SLOT_Y_PX            240
+
+// 像素 -> 车体位移 (mm/像素), 随目标所在平面高度不同
+#define VSERVO_BLOCK_MM_PER_PX      0.45f
+#define VSERVO_PLATFORM_MM_PER_PX   0.40f
+#define VSERVO_SLOT_MM_PER_PX       0.40f
+
+// 图像方向 -> 车体方向: 目标在图像中偏右(x增大)需要车体右移, 偏下(y增大)需要车体后退
+#define VSERVO_IMG_X_TO_RIGHT       (+1)
+#define VSERVO_IMG_Y_TO_FWD         (-1)
+
+#define VSERVO_PERIOD_MS            20      // 速度设定下发周期 (ms)
+#define VSERVO_FPS                  30      // 推流帧率
+#define VSERVO_TOL_PX               4       // 完成容差 (像素)
+#define VSERVO_DONE_FRAMES          5       // 连续N帧在容差内即完成
+#define VSERVO_KP_FAR               6.0f    // 大误差时比例增益 (1/s)
+#define VSERVO_KP_NEAR              3.0f    // 小误差时比例增益 (1/s)
+#define VSERVO_SCHED_MM             30.0f   // 误差在0~此值之间增益线性过渡 (mm)
+#define VSERVO_KI                   1.5f    // 积分增益 (1/s^2)
+#define VSERVO_I_ZONE_MM            10.0f   // 误差小于此值才积分 (mm)
+#define VSERVO_I_LIMIT_MM_S         15.0f   // 积分项限幅 (mm/s)
+#define VSERVO_V_MAX_MM_S           150.0f  // 速度限幅 (mm/s)
+#define VSERVO_ACC_MM_S2            600.0f  // 设定速度变化率限幅 (mm/s^2)
+#define VSERVO_HIST_SIZE            32      // 速度设定历史 (覆盖 32 x 周期 的延迟)
+#define VSERVO_LOST_MS              300     // 超过此时间未检测到目标则中止 (ms)
+#define VSERVO_TIMEOUT_MS           6000    // 单次对位超时 (ms)
+
+/* ==================== 类型定义 ==================== */
+
+typedef enum {
+    VSERVO_OK = 0,          // 对位完成
+    VSERVO_LOST,            // 目标丢失
+    VSERVO_TIMEOUT,         // 超时未收敛
+    VSERVO_STALL,           // 车轮堵转
+    VSERVO_NO_STREAM        // 未收到推流帧
+} VisualServoResult_t;
+
+/**
+ * @brief 单次对位统计
+ */
+typedef struct {
+    uint32_t time_ms;       // 总用时
+    uint16_t frames;        // 使用的推流帧数
+    uint16_t rejected;      // 任务/颜色与请求目标不符而丢弃的帧数
+    float    err_x_mm;      // 结束时最后一帧的误差 (车体前向)
+    float    err_y_mm;      // 结束时最后一帧的误差 (车体右向)
+    uint16_t latency_ms;    // 平均采集延迟 (采集到使用)
+} VisualServoStats_t;
+
+/* ==================== 公开函数声明 ==================== */
+
+/**
+ * @brief 视觉伺服对位: 开启推流, 以速度模式连续逼近目标, 完成后停车并停止推流
+ * @param target_type 目标类型 (物块/凸台/凹槽)
+ * @param color 目标颜色 (物块/凸台/凹槽按颜色区分时使用)
+ * @return VisualServoResult_t
+ */
+VisualServoResult_t Visual_Servo_Align(TargetType_t target_type, ColorTarget_t color);
+
+/**
+ * @brief 像素误差 -> 车体系位移误差
+ * @note 该目标已标定时使用Visual_Calib_Map
+ * @param target_type 目标类型
+ * @param x_px/y_px 目标在图像中的像素坐标
+ * @param dx_mm 输出: 车体需前进的距离
+ * @param dy_mm 输出: 车体需右移的距离
+ */
+void Visual_Servo_Pixel_To_Chassis(TargetType_t target_type, float x_px, float y_px,
+                                   float *dx_mm, float *dy_mm);
+
+/**
+ * @brief 获取最近一次对位的统计
+ */
+const VisualServoStats_t *Visual_Servo_Get_Stats(void);
+
+#endif /* __VISUAL_SERVO_H */
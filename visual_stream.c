@@ -0,0 +1,454 @@
+/**
+  ******************************************************************************
+  * @file    visual_stream.c
+  * @brief   LubanCat视觉推流模式实现
+  * @details 视觉串口以DMA循环模式+IDLE中断接收, 启动后不再重新启动接收:
+  *          - DMA半满/全满/IDLE事件中从上次解析位置起原地遍历缓冲区, 逐帧解码
+  *          - 缓冲区长度大于半缓冲区+最大帧长, 解析位置不会被DMA写入位置追上, 不丢字节
+  *          完整帧:
+  *          - 采集时刻 = 接收完成时刻 - 帧传输时间 - LubanCat上报的采集延迟
+  *          - 写入VIS_RX对应目标, 并以序号锁发布整帧快照
+  *          - 全目标帧以CRC16校验, 版本不符的帧丢弃, 不会以错误坐标驱动底盘
+  ******************************************************************************
+  */
+
+#include "visual_stream.h"
+#include "motor.h"
+#include "crc16.h"
+#include <string.h>
+
+/* ==================== 私有变量 ==================== */
+
+static uint8_t  s_dma_buf[VISUAL_RX_DMA_BUF_SIZE];
+static uint16_t s_wr = 0;                   // DMA已写入位置 (最近一次接收事件)
+static uint16_t s_rd = 0;                   // 已解析到的位置
+
+static __IO uint32_t s_frame_sync = 0;      // 写入时为奇数
+static VisualFrame_t s_last;
+static __IO uint32_t s_scene_sync = 0;      // 写入时为奇数
+static VisualScene_t s_scene;
+static bool          s_have_seq = false;
+static uint16_t      s_last_seq = 0;        // 最近一帧的LubanCat帧序号 (两种帧共用)
+static bool          s_active = false;
+static bool          s_rx_owned = false;    // USART3接收由本模块占用
+static uint8_t       s_task = 0;            // 推流目标
+static uint8_t       s_color = 0;
+static VisualStreamStats_t s_stats;
+
+/* ==================== 私有函数 ==================== */
+
+/**
+ * @brief 读取环形缓冲区中解析位置之后第i个字节
+ */
+static uint8_t at(uint16_t i)
+{
+    return s_dma_buf[(uint16_t)(s_rd + i) % VISUAL_RX_DMA_BUF_SIZE];
+}
+
+static uint16_t at16(uint16_t i)
+{
+    return (uint16_t)(at(i) | ((uint16_t)at((uint16_t)(i + 1U)) << 8));
+}
+
+static void skip(uint16_t n)
+{
+    s_rd = (uint16_t)((s_rd + n) % VISUAL_RX_DMA_BUF_SIZE);
+}
+
+static uint8_t sum8(const uint8_t *p, uint8_t len)
+{
+    uint8_t s = 0;
+
+    while (len--) {
+        s = (uint8_t)(s + *p++);
+    }
+    return s;
+}
+
+/**
+ * @brief 解析位置处[from, from+len)的CRC16-CCITT (多项式0x1021, 初值0xFFFF)
+ */
+static uint16_t crc16_at(uint16_t from, uint16_t len)
+{
+    uint16_t crc = CRC16_INIT;
+
+    while (len--) {
+        crc = Crc16_Update(crc, at(from++));
+    }
+    return crc;
+}
+
+/**
+ * @brief 帧传输时间 (ms, 8N1)
+ */
+static uint32_t wire_ms(uint8_t len)
+{
+    uint32_t baud = huart3.Init.BaudRate ? huart3.Init.BaudRate : 115200U;
+
+    return ((uint32_t)len * 10U * 1000U + baud / 2U) / baud;
+}
+
+/**
+ * @brief (任务, 颜色) -> 全目标帧中的目标编号
+ * @return VIS_OBJ_COUNT表示无对应目标
+ */
+static uint8_t task_to_obj(uint8_t task, uint8_t color)
+{
+    switch (task) {
+        case TASK_IDENTIFY_MATERIAL:
+            if (color == COLOR_RED)   return VIS_OBJ_RED;
+            if (color == COLOR_GREEN) return VIS_OBJ_GREEN;
+            if (color == COLOR_BLUE)  return VIS_OBJ_BLUE;
+            return VIS_OBJ_COUNT;
+        case TASK_PLATFORM: return VIS_OBJ_PLATFORM;
+        case TASK_SLOT:     return VIS_OBJ_SLOT;
+        default:            return VIS_OBJ_COUNT;
+    }
+}
+
+/**
+ * @brief 最新检测写入VIS_RX, 未检测到目标时坐标清零
+ */
+static void vis_rx_update(uint8_t obj, bool found, uint16_t x, uint16_t y)
+{
+    if (!found) {
+        x = 0;
+        y = 0;
+    }
+    switch (obj) {
+        case VIS_OBJ_RED:      VIS_RX.r_block_x = x;  VIS_RX.r_block_y = y;  break;
+        case VIS_OBJ_GREEN:    VIS_RX.g_block_x = x;  VIS_RX.g_block_y = y;  break;
+        case VIS_OBJ_BLUE:     VIS_RX.b_block_x = x;  VIS_RX.b_block_y = y;  break;
+        case VIS_OBJ_PLATFORM: VIS_RX.platform_x = x; VIS_RX.platform_y = y; break;
+        case VIS_OBJ_SLOT:     VIS_RX.slot_x = x;     VIS_RX.slot_y = y;     break;
+        default: break;
+    }
+}
+
+/**
+ * @brief 按帧序号统计丢帧
+ */
+static void seq_track(uint16_t seq)
+{
+    if (s_have_seq && (uint16_t)(seq - s_last_seq) > 1U) {
+        s_stats.lost += (uint16_t)(seq - s_last_seq - 1U);
+    }
+    s_have_seq = true;
+    s_last_seq = seq;
+    s_stats.frames++;
+}
+
+/**
+ * @brief 单目标检测帧 (位于解析位置处): 原地解码并发布
+ */
+static void det_dispatch(uint32_t capture_tick, uint32_t now)
+{
+    VisualFrame_t *d = &s_last;
+
+    if (at(2) != 12U) {
+        return;
+    }
+    seq_track(at16(4));
+
+    s_frame_sync++;
+    d->count++;
+    d->seq = s_last_seq;
+    d->rx_tick = now;
+    d->capture_tick = capture_tick - at16(6);
+    d->task = at(8);
+    d->color = at(9);
+    d->found = at(10);
+    d->conf = d->found ? 100U : 0U;
+    d->x = at16(11);
+    d->y = at16(13);
+    d->w = 0;
+    d->h = 0;
+    vis_rx_update(task_to_obj(d->task, d->color), d->found != 0, d->x, d->y);
+    s_frame_sync++;
+}
+
+/**
+ * @brief 全目标帧 (位于解析位置处): 原地解码, 发布全目标快照,
+ *        并把推流目标对应的一项发布为VisualFrame_t
+ */
+static void scene_dispatch(uint32_t capture_tick, uint32_t now)
+{
+    VisualScene_t *sc = &s_scene;
+    uint8_t n = at(9);
+    uint8_t want = task_to_obj(s_task, s_color);
+    uint8_t i;
+
+    if (at(4) != VISUAL_SCENE_VERSION) {
+        s_stats.bad_version++;
+        return;
+    }
+    if (at(2) != (uint8_t)(7U + n * 10U)) {
+        s_stats.resync++;
+        return;
+    }
+    seq_track(at16(5));
+    capture_tick -= at16(7);
+
+    s_scene_sync++;
+    sc->count++;
+    sc->seq = s_last_seq;
+    sc->capture_tick = capture_tick;
+    sc->rx_tick = now;
+    memset(sc->obj, 0, sizeof(sc->obj));   // 帧中未列出的目标视为未检测到
+    for (i = 0; i < n; i++) {
+        uint16_t p = (uint16_t)(10U + i * 10U);
+        uint8_t id = at(p);
+
+        if (id < VIS_OBJ_COUNT) {
+            sc->obj[id].conf = at((uint16_t)(p + 1U));
+            sc->obj[id].x = at16((uint16_t)(p + 2U));
+            sc->obj[id].y = at16((uint16_t)(p + 4U));
+            sc->obj[id].w = at16((uint16_t)(p + 6U));
+            sc->obj[id].h = at16((uint16_t)(p + 8U));
+        }
+    }
+    for (i = 0; i < VIS_OBJ_COUNT; i++) {
+        vis_rx_update(i, sc->obj[i].conf >= VISUAL_SCENE_MIN_CONF, sc->obj[i].x, sc->obj[i].y);
+    }
+    s_scene_sync++;
+
+    if (s_active && want < VIS_OBJ_COUNT) {
+        VisualFrame_t *d = &s_last;
+        const VisualTarget_t *t = &sc->obj[want];
+
+        s_frame_sync++;
+        d->count++;
+        d->seq = sc->seq;
+        d->rx_tick = now;
+        d->capture_tick = capture_tick;
+        d->task = s_task;
+        d->color = s_color;
+        d->found = (t->conf >= VISUAL_SCENE_MIN_CONF) ? 1U : 0U;
+        d->conf = t->conf;
+        d->x = t->x;
+        d->y = t->y;
+        d->w = t->w;
+        d->h = t->h;
+        s_frame_sync++;
+    }
+}
+
+/**
+ * @brief 完整帧 (位于解析位置处): 按类型分发
+ */
+static void frame_dispatch(uint8_t len)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t capture_tick = now - wire_ms(len);     // 未减去LubanCat上报的采集延迟
+
+    switch (at(3)) {
+        case VISUAL_STREAM_TYPE_DET:   det_dispatch(capture_tick, now);      break;
+        case VISUAL_STREAM_TYPE_SCENE: scene_dispatch(capture_tick, now);    break;
+        default: break;     // 未知帧类型: 校验已通过, 直接跳过
+    }
+}
+
+/**
+ * @brief 从解析位置起逐帧遍历DMA缓冲区, 不拷贝
+ * @note 不完整的帧留在缓冲区中等待后续字节; 帧头之后的长度/校验错误时只跳过一个字节,
+ *       其后的字节原地重新解析, 不会丢失紧随其后的有效帧
+ */
+static void stream_walk(void)
+{
+    uint16_t avail = (uint16_t)((s_wr + VISUAL_RX_DMA_BUF_SIZE - s_rd) % VISUAL_RX_DMA_BUF_SIZE);
+
+    while (avail >= 4U) {
+        uint8_t len, need, trailer;
+        bool ok;
+
+        if (at(0) != VISUAL_STREAM_HEAD1 || at(1) != VISUAL_STREAM_HEAD2) {
+            skip(1);
+            avail--;
+            continue;
+        }
+        // 帧头2 + len + 内容 + 校验 (单目标帧1字节校验和, 其余类型2字节CRC16)
+        len = at(2);
+        trailer = (at(3) == VISUAL_STREAM_TYPE_DET) ? 1U : 2U;
+        if (len == 0 || (uint16_t)len + 3U + trailer > VISUAL_STREAM_FRAME_MAX) {
+            s_stats.resync++;
+            skip(1);
+            avail--;
+            continue;
+        }
+        need = (uint8_t)(len + 3U + trailer);
+        if (avail < need) {
+            break;
+        }
+        if (trailer == 1U) {
+            uint8_t sum = 0;
+            uint8_t i;
+
+            for (i = 2; i < need - 1U; i++) {
+                sum = (uint8_t)(sum + at(i));
+            }
+            ok = (sum == at((uint16_t)(need - 1U)));
+        } else {
+            ok = (crc16_at(2, (uint16_t)(len + 1U)) == at16((uint16_t)(need - 2U)));
+        }
+        if (!ok) {
+            s_stats.bad_sum++;
+            s_stats.resync++;
+            skip(1);
+            avail--;
+            continue;
+        }
+        frame_dispatch(need);
+        skip(need);
+        avail = (uint16_t)(avail - need);
+    }
+}
+
+static void send_ctrl(uint8_t cmd, uint8_t task, uint8_t color, uint8_t fps)
+{
+    uint8_t f[8] = { VISUAL_STREAM_HEAD1, VISUAL_STREAM_HEAD2, 4, cmd, task, color, fps, 0 };
+
+    f[7] = sum8(&f[2], 5);
+    HAL_UART_Transmit(&huart3, f, sizeof(f), VISUAL_STREAM_TX_TIMEOUT_MS);
+}
+
+/* ==================== 公开函数 ==================== */
+
+void Visual_Stream_Start(VisualTask_t task, uint8_t color, uint8_t fps)
+{
+    if (fps == 0) {
+        fps = VISUAL_STREAM_DEFAULT_FPS;
+    }
+    if (!s_rx_owned) {
+        Visual_Stream_Rx_Init();
+    }
+    s_have_seq = false;         // 新的推流会话, 序号重新开始
+    s_task = (uint8_t)task;
+    s_color = color;
+    s_active = true;
+    send_ctrl(VISUAL_STREAM_CMD_START, (uint8_t)task, color, fps);
+}
+
+void Visual_Stream_Stop(void)
+{
+    send_ctrl(VISUAL_STREAM_CMD_STOP, 0, 0, 0);
+    s_active = false;
+}
+
+bool Visual_Stream_Active(void)
+{
+    return s_active;
+}
+
+void Visual_Stream_Rx_Init(void)
+{
+    if (s_rx_owned) {
+        HAL_UART_AbortReceive(&huart3);
+    }
+    s_wr = 0;
+    s_rd = 0;
+    s_rx_owned = true;
+    HAL_UARTEx_ReceiveToIdle_DMA(&huart3, s_dma_buf, VISUAL_RX_DMA_BUF_SIZE);
+}
+
+void Visual_Stream_Rx_Release(void)
+{
+    if (!s_rx_owned) {
+        return;
+    }
+    if (s_active) {
+        Visual_Stream_Stop();
+    }
+    s_rx_owned = false;
+    HAL_UART_AbortReceive(&huart3);
+}
+
+bool Visual_Stream_Rx_Owned(void)
+{
+    return s_rx_owned;
+}
+
+void Visual_Stream_EventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    if (huart != &huart3 || !s_rx_owned || Size > VISUAL_RX_DMA_BUF_SIZE) {
+        return;
+    }
+    // 循环模式下Size为DMA写入位置, 全满时为缓冲区长度
+    s_wr = (Size >= VISUAL_RX_DMA_BUF_SIZE) ? 0U : Size;
+    stream_walk();
+}
+
+void Visual_Stream_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == &huart3 && s_rx_owned) {
+        // 溢出/噪声/帧错误会停止DMA: 重新启动, 缓冲区中尚未完整的帧丢弃
+        Visual_Stream_Rx_Init();
+    }
+}
+
+bool Visual_Stream_Get(VisualFrame_t *out)
+{
+    uint32_t seq;
+
+    do {
+        seq = s_frame_sync;
+        memcpy(out, &s_last, sizeof(*out));
+    } while ((seq & 1U) || seq != s_frame_sync);
+    return out->count != 0;
+}
+
+bool Visual_Stream_Frame_Matches(const VisualFrame_t *f)
+{
+    return f->task == s_task && f->color == s_color;
+}
+
+bool Visual_Stream_Wait_Newer(uint32_t count, uint32_t timeout_ms, VisualFrame_t *out)
+{
+    uint32_t tickstart = HAL_GetTick();
+
+    while (s_last.count == count) {
+        if (HAL_GetTick() - tickstart > timeout_ms) {
+            return false;
+        }
+        Motor_Background_Process();
+    }
+    return Visual_Stream_Get(out);
+}
+
+bool Visual_Scene_Get(VisualScene_t *out)
+{
+    uint32_t seq;
+
+    do {
+        seq = s_scene_sync;
+        memcpy(out, &s_scene, sizeof(*out));
+    } while ((seq & 1U) || seq != s_scene_sync);
+    return out->count != 0;
+}
+
+bool Visual_Scene_Request(uint32_t timeout_ms, VisualScene_t *out)
+{
+    uint32_t count = s_scene.count;
+    uint32_t tickstart = HAL_GetTick();
+
+    if (!s_rx_owned) {
+        Visual_Stream_Rx_Init();
+    }
+    send_ctrl(VISUAL_STREAM_CMD_SCENE, 0, 0, 0);
+    while (s_scene.count == count) {
+        if (HAL_GetTick() - tickstart > timeout_ms) {
+            return false;
+        }
+        Motor_Background_Process();
+    }
+    return Visual_Scene_Get(out);
+}
+
+uint32_t Visual_Stream_Age_ms(const VisualFrame_t *f)
+{
+    return HAL_GetTick() - f->capture_tick;
+}
+
+const VisualStreamStats_t *Visual_Stream_Get_Stats(void)
+{
+    return &s_stats;
+}
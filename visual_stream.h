@@ -0,0 +1,221 @@
+/**
+  ******************************************************************************
+  * @file    visual_stream.h
+  * @brief   LubanCat视觉推流模式头文件
+  * @details 推流模式下LubanCat按帧率连续推送检测结果, 不再逐次请求-应答:
+  *          - 每帧带LubanCat帧序号与采集延迟, 换算为本机时基的采集时刻
+  *          - 解析出完整帧后同步更新VIS_RX对应目标的坐标, VIS_RX始终为最新一帧
+  *          - 以序号锁发布完整帧快照, 控制环可按采集时刻做延迟补偿
+  *          - 帧序号不连续计为丢帧, 校验错误的帧丢弃并重新同步
+  *          视觉串口(USART3)以DMA循环模式+IDLE中断接收, 默认由本模块占用:
+  *          RX DMA须配置为DMA_CIRCULAR, 启动后无需重新启动接收.
+  *          visual_comm.c的旧请求-应答接口(Visual_UART_Start_Receive/Visual_Wait_Response等)
+  *          以中断方式接收同一串口, 与推流接收不能同时进行: 使用旧接口前调用
+  *          Visual_Stream_Rx_Release()交出接收, 之后的Visual_Stream_Start/Visual_Scene_Request
+  *          自动收回
+  *
+  *          帧格式 (LubanCat -> STM32, 多字节字段小端), 帧头与长度字段所有类型相同:
+  *          A5 5A | len | type | ... | 校验
+  *          len为type到校验之前的字节数
+  *
+  *          type=0x01 单目标检测帧 (旧版LubanCat程序), 校验为len到y的字节和低8位:
+  *          A5 5A | len | 01 | seq(2) | age_ms(2) | task | color | found | x(2) | y(2) | sum
+  *
+  *          type=0x02 全目标帧, 一帧携带三色物块/凸台/凹槽的全部检测结果:
+  *          A5 5A | len | 02 | ver | seq(2) | age_ms(2) | n | n x 目标 | crc16(2)
+  *          目标 = id(VisualObject_t) | conf(0~100) | x(2) | y(2) | w(2) | h(2)
+  *          crc16为len到最后一个目标的CRC16-CCITT (多项式0x1021, 初值0xFFFF,
+  *          即Python binascii.crc_hqx(data, 0xFFFF)); ver不等于VISUAL_SCENE_VERSION的帧丢弃
+  *
+  *          age_ms为图像采集到该帧开始发送的时间 (LubanCat计时)
+  *
+  *          控制帧 (STM32 -> LubanCat):
+  *          A5 5A | 04 | cmd | task | color | fps | sum
+  *          推流中两种检测帧都可使用, 全目标帧中与推流目标对应的一项发布为VisualFrame_t
+  ******************************************************************************
+  */
+
+#ifndef __VISUAL_STREAM_H
+#define __VISUAL_STREAM_H
+
+#include "visual_comm.h"
+#include <stdbool.h>
+
+/* ==================== 配置参数 ==================== */
+
+#define VISUAL_STREAM_HEAD1         0xA5
+#define VISUAL_STREAM_HEAD2         0x5A
+#define VISUAL_STREAM_TYPE_DET      0x01    // 单目标检测帧
+#define VISUAL_STREAM_TYPE_SCENE    0x02    // 全目标帧
+#define VISUAL_STREAM_CMD_START     0x20    // 开始推流
+#define VISUAL_STREAM_CMD_STOP      0x21    // 停止推流
+#define VISUAL_STREAM_CMD_SCENE     0x22    // 请求一帧全目标帧
+#define VISUAL_STREAM_FRAME_MAX     96      // 单帧最大长度
+#define VISUAL_SCENE_VERSION        1       // 全目标帧版本
+#define VISUAL_SCENE_MIN_CONF       50      // 低于此置信度视为未检测到
+#define VISUAL_RX_DMA_BUF_SIZE      256     // DMA循环接收缓冲区, 须大于 半缓冲区+单帧最大长度
+#define VISUAL_STREAM_DEFAULT_FPS   30      // 默认推流帧率
+#define VISUAL_STREAM_TX_TIMEOUT_MS 10      // 控制帧发送超时
+
+/* ==================== 类型定义 ==================== */
+
+/**
+ * @brief 全目标帧中的目标编号
+ */
+typedef enum {
+    VIS_OBJ_RED = 0,
+    VIS_OBJ_GREEN,
+    VIS_OBJ_BLUE,
+    VIS_OBJ_PLATFORM,
+    VIS_OBJ_SLOT,
+    VIS_OBJ_COUNT
+} VisualObject_t;
+
+/**
+ * @brief 单个目标的检测结果
+ */
+typedef struct {
+    uint8_t  conf;          // 置信度 0~100, 0表示未检测到
+    uint16_t x;             // 中心像素坐标
+    uint16_t y;
+    uint16_t w;             // 外接框尺寸 (像素)
+    uint16_t h;
+} VisualTarget_t;
+
+/**
+ * @brief 全目标帧
+ */
+typedef struct {
+    uint32_t count;         // 本机收到的全目标帧计数
+    uint16_t seq;           // LubanCat帧序号
+    uint32_t capture_tick;  // 图像采集时刻 (HAL_GetTick时基)
+    uint32_t rx_tick;       // 帧接收完成时刻
+    VisualTarget_t obj[VIS_OBJ_COUNT];
+} VisualScene_t;
+
+/**
+ * @brief 推流检测帧
+ */
+typedef struct {
+    uint32_t count;         // 本机收到的有效帧计数 (用于判断是否有新帧)
+    uint16_t seq;           // LubanCat帧序号
+    uint32_t capture_tick;  // 图像采集时刻 (HAL_GetTick时基)
+    uint32_t rx_tick;       // 帧接收完成时刻
+    uint8_t  task;          // VisualTask_t
+    uint8_t  color;         // ColorTarget_t
+    uint8_t  found;         // 1=检测到目标 (全目标帧: 置信度不低于VISUAL_SCENE_MIN_CONF)
+    uint8_t  conf;          // 置信度 0~100 (单目标帧: 检测到为100)
+    uint16_t x;             // 像素坐标
+    uint16_t y;
+    uint16_t w;             // 外接框尺寸 (单目标帧为0)
+    uint16_t h;
+} VisualFrame_t;
+
+/**
+ * @brief 推流统计
+ */
+typedef struct {
+    uint32_t frames;        // 有效帧数
+    uint32_t lost;          // 按帧序号推算的丢帧数
+    uint32_t bad_sum;       // 校验和/CRC错误
+    uint32_t bad_version;   // 不支持的全目标帧版本
+    uint32_t resync;        // 帧格式错误后重新同步次数
+} VisualStreamStats_t;
+
+/* ==================== 公开函数声明 ==================== */
+
+/**
+ * @brief 请求LubanCat开始推流
+ * @param task 识别任务 (TASK_IDENTIFY_MATERIAL/TASK_PLATFORM/TASK_SLOT)
+ * @param color 目标颜色 (ColorTarget_t)
+ * @param fps 推流帧率, 0表示VISUAL_STREAM_DEFAULT_FPS
+ */
+void Visual_Stream_Start(VisualTask_t task, uint8_t color, uint8_t fps);
+
+/**
+ * @brief 请求LubanCat停止推流
+ */
+void Visual_Stream_Stop(void);
+
+/**
+ * @brief 推流是否开启
+ */
+bool Visual_Stream_Active(void);
+
+/**
+ * @brief 启动视觉串口的DMA循环接收, 本模块占用USART3接收
+ * @note 在MX_USART3_UART_Init()和MX_DMA_Init()之后调用一次
+ */
+void Visual_Stream_Rx_Init(void);
+
+/**
+ * @brief 交出视觉串口接收, 供visual_comm.c的旧请求-应答接口使用
+ * @note 推流中先发送停止命令. 交出后本模块不处理USART3的接收事件,
+ *       HAL_UART_RxCpltCallback转给Visual_UART_RxCallback
+ */
+void Visual_Stream_Rx_Release(void);
+
+/**
+ * @brief 本模块是否占用视觉串口接收
+ */
+bool Visual_Stream_Rx_Owned(void);
+
+/**
+ * @brief 接收事件处理 (DMA半满/全满/IDLE), 非视觉串口或已交出接收时直接返回
+ * @note 由HAL_UARTEx_RxEventCallback()调用 (hal_callbacks.c)
+ */
+void Visual_Stream_EventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+
+/**
+ * @brief 接收错误处理, 重新启动DMA接收, 非视觉串口或已交出接收时直接返回
+ * @note 由HAL_UART_ErrorCallback()调用 (hal_callbacks.c)
+ */
+void Visual_Stream_ErrorCallback(UART_HandleTypeDef *huart);
+
+/**
+ * @brief 读取最新一帧 (序号锁快照)
+ * @return false=尚未收到任何帧
+ */
+bool Visual_Stream_Get(VisualFrame_t *out);
+
+/**
+ * @brief 帧的识别任务与颜色是否为最近一次Visual_Stream_Start请求的目标
+ * @note 切换目标后LubanCat仍可能发出几帧旧目标的结果, 使用前须用此函数过滤
+ */
+bool Visual_Stream_Frame_Matches(const VisualFrame_t *f);
+
+/**
+ * @brief 等待比count更新的一帧
+ * @param count 上一次读到的VisualFrame_t.count
+ * @param timeout_ms 超时时间
+ * @param out 输出新帧
+ * @return false=超时
+ */
+bool Visual_Stream_Wait_Newer(uint32_t count, uint32_t timeout_ms, VisualFrame_t *out);
+
+/**
+ * @brief 读取最新全目标帧 (序号锁快照)
+ * @return false=尚未收到任何全目标帧
+ */
+bool Visual_Scene_Get(VisualScene_t *out);
+
+/**
+ * @brief 请求一帧全目标帧并等待
+ * @param timeout_ms 超时时间
+ * @param out 输出全目标帧
+ * @return false=超时
+ * @note 一次交互取得三色物块/凸台/凹槽的全部坐标, 并同步更新VIS_RX
+ */
+bool Visual_Scene_Request(uint32_t timeout_ms, VisualScene_t *out);
+
+/**
+ * @brief 帧的采集时刻距今的时间 (ms)
+ */
+uint32_t Visual_Stream_Age_ms(const VisualFrame_t *f);
+
+/**
+ * @brief 获取推流统计
+ */
+const VisualStreamStats_t *Visual_Stream_Get_Stats(void);
+
+#endif /* __VISUAL_STREAM_H */